@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <string>
 
@@ -18,54 +19,257 @@
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
 #include <onnxruntime_cxx_api.h>
-#include <iostream>
 #include <vector>
 #include <cmath>
 #include <span>
 
+#include "ClassificationHistory.h"
+#include "InferenceService.h"
+#include "LabelGroups.h"
+#include "LatencyHistogram.h"
+#include "LogMelFrontend.h"
+#include "RealtimeLog.h"
 #include "SampleRateConversion.h"
+#include "SilenceGate.h"
+#include "SpectralChangeDetector.h"
+#include "Trace.h"
+#include "TripleBuffer.h"
+
+//===============================================================================================
+enum class AnalysisState
+{
+    warmingUp,   // The shared model is still loading
+    running,
+    unavailable  // The model failed to load
+};
+
+// How often windows are sent to the model
+enum class InferenceMode
+{
+    full,    // Every hop: something is consuming the results
+    lowDuty, // One hop in every getLowDutyInterval()
+    off      // Nothing is submitted; the window ring keeps filling so full rate resumes instantly
+};
+
+struct ClassificationResult
+{
+    static constexpr size_t numClasses = 521;
+
+    uint64_t sequence = 0;      // 0 until the first inference has completed
+    uint64_t audioPosition = 0; // End of the analysed window, in 16k samples since prepareToPlay
+    juce::int64 timeMs = 0;     // Wall clock when the result was published
+    std::array<float, numClasses> scores {};
+
+    // Highest class score within each label_groups::groups entry; this is all the UI receives
+    std::array<float, label_groups::numGroups> groupScores {};
+};
 
 
 //===============================================================================================
-class AudioClassification
+// The audio thread only pushes samples into a lock-free single-producer/single-consumer ring.
+// A dedicated analysis thread drains that ring, streams the audio through the resampler into a
+// 16k window ring as it arrives (and, for the backbone-only model, through the log-mel front end),
+// and submits each window to the shared InferenceService, so nothing on the audio thread ever waits
+// on ONNX Runtime.
+//
+// Every published result also sends a change message, so the editor can push it to the UI as it
+// arrives instead of polling. Messages coalesce, so a slow message thread only sees the latest one.
+class AudioClassification : public juce::ChangeBroadcaster,
+                            private juce::Thread,
+                            private InferenceService::Client
 {
 public:
     AudioClassification();
     virtual ~AudioClassification();
   
-    std::vector<float> getOutputScores() const;
-    
-    void prepareToPlay(const double sampleRate, const int samplesPerBlock, const int detectionFrequency);
+    // Message thread (single consumer): latest published result. Never blocks the analysis
+    // worker and never allocates; the reference stays valid until the next call.
+    const ClassificationResult& getLatestResult();
+
+    // Every recent result, kept for as long as the processor lives (see ClassificationHistory)
+    const ClassificationHistory& getHistory() const noexcept { return history; }
     
-    void processSample(const float sample);
-    void processClassification(std::span<float> stft_input);
+    // Stops the analysis worker (if running), resizes every buffer and restarts it.
+    void prepareToPlay(const double sampleRate, const int samplesPerBlock, const double detectionRateHz);
+    void releaseResources();
+
+    // Audio thread: copies the block into the ring in at most two memcpy chunks and never blocks.
+    // Samples that don't fit are dropped (and counted) if the worker has fallen behind.
+    void processBlock(std::span<const float> samples);
+    bool processClassification(std::span<float> stft_input, uint64_t tag);
+
+    AnalysisState getAnalysisState() const noexcept;
+
+    // Results per second, from one per window (no overlap) up to maxDetectionRateHz. Any thread,
+    // including the audio thread: the worker picks the new hop size up at the next hop boundary,
+    // and the window ring never changes size.
+    static constexpr double minDetectionRateHz = 16000.0 / InferenceService::waveformLength;
+    static constexpr double maxDetectionRateHz = 8.0;
+    static constexpr double defaultDetectionRateHz = 2.0 * minDetectionRateHz; // 50% overlap
+
+    void setDetectionRate(double rateHz) noexcept;
+    double getDetectionRate() const noexcept;
+
+    // Time from construction to the first published result, or 0 until then
+    double getTimeToFirstScoreMs() const noexcept { return timeToFirstScoreMs.load(std::memory_order_relaxed); }
+
+    // Anything that reads the results (a visible editor, a recorder, ...) registers itself while it
+    // does. With no consumers, inference falls back to the idle mode.
+    void addConsumer() noexcept { numConsumers.fetch_add(1, std::memory_order_relaxed); }
+    void removeConsumer() noexcept { numConsumers.fetch_sub(1, std::memory_order_relaxed); }
+
+    void setIdleMode(InferenceMode newMode) noexcept { idleMode.store(newMode, std::memory_order_relaxed); }
+    void setLowDutyInterval(int hops) noexcept { lowDutyInterval.store(juce::jmax(1, hops), std::memory_order_relaxed); }
+    int getLowDutyInterval() const noexcept { return lowDutyInterval.load(std::memory_order_relaxed); }
+
+    InferenceMode getInferenceMode() const noexcept;
+
+    struct ThrottleStats
+    {
+        InferenceMode mode;
+        int windowsSubmitted;     // Since prepareToPlay
+        int windowsThrottled;     // Skipped because nothing was consuming them
+        double estimatedSavedMs;  // windowsThrottled at the service's mean run time per window
+    };
 
-    void testONNXRuntime();
+    ThrottleStats getThrottleStats() const noexcept;
+
+    // Quiet stretches skip the resampler and the model and publish a synthetic Silence result
+    SilenceGate& getSilenceGate() noexcept { return silenceGate; }
+
+    struct SilenceStats
+    {
+        int windowsGated;   // Since prepareToPlay, published as Silence without running the model
+        int checksRun;      // Gated windows also run through the model to confirm the gate
+        int checksAgreed;   // ...where the model's top group was Silence too
+        bool reopened;      // A check disagreed, so quiet audio runs through the model until it gets loud
+    };
+
+    SilenceStats getSilenceStats() const noexcept;
+
+    // Steady audio reuses the last model result while no band of the coarse spectrum has moved by
+    // more than the tolerance, for at most the maximum age. A tolerance of 0 turns reuse off.
+    void setReuseToleranceDb(float newToleranceDb) noexcept { reuseToleranceDb.store(newToleranceDb, std::memory_order_relaxed); }
+    void setMaxReuseAgeMs(double newMaxAgeMs) noexcept { maxReuseAgeMs.store(newMaxAgeMs, std::memory_order_relaxed); }
+
+    struct ReuseStats
+    {
+        int windowsReused;  // Since prepareToPlay
+        float reuseRate;    // Reused / (reused + submitted)
+    };
+
+    ReuseStats getReuseStats() const noexcept;
+
+    int getNumDroppedSamples() const noexcept { return droppedSamples.load(std::memory_order_relaxed); }
+    int getNumDroppedWindows() const noexcept { return droppedWindows.load(std::memory_order_relaxed); }
+
+    // Host samples written by processBlock that the worker hasn't drained yet
+    int getNumPendingSamples() const noexcept { return ingestFifo.getNumReady(); }
+
+    struct LatencyStats
+    {
+        LatencyHistogram::Snapshot inference;  // submit() to result, batching and queueing included
+        LatencyHistogram::Snapshot resampling; // Per resampler call, up to maxResampleChunkSize host samples
+        LatencyHistogram::Snapshot modelRun;   // ONNX Runtime time per window, shared by every instance
+        int windowsLate;                       // Results that took longer than a hop, so the display fell behind
+    };
+
+    // Since prepareToPlay; any thread
+    LatencyStats getLatencyStats() const noexcept;
 
 private:
+    void run() override;
+    void drainIngestFifo();
+    void resampleAndAppend(std::span<const float> hostSamples);
+    void appendToWindow(const float* samples, int numSamples, bool isSilence);
+    void analyseWindow();
+    bool shouldAnalyseHop();
+    bool tryReusePreviousResult();
+
+    void inferenceCompleted(std::span<const float> scores, uint64_t tag, juce::int64 submissionTicks) override;
+    void checkSilenceGate(std::span<const float> scores);
+
+    // Called on the scheduler thread for model output and on the worker for gated windows
+    void publishResult(std::span<const float> scores, uint64_t windowEnd);
+
     SampleRateConversion SRC;
+    std::vector<float> resampledBlock; // 16k output of one resampler call
+    static constexpr int maxResampleChunkSize = 4096;
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo ingestFifo { 1 };
+    std::vector<float> ingestBuffer;
+    std::atomic<int> droppedSamples { 0 };
 
-    // Handle Input to Classification
-    int fifoSize = 0;  // Stores the computed buffer size
-    int hopSize = 0;               // Hop size (half of classifierBufferSize)
+    static constexpr double analysisSampleRate = 16000.0;
+    static constexpr int workerPollIntervalMs = 10;
+    static constexpr int workerStopTimeoutMs = 2000;
+
+    // Handle Input to Classification (all at 16k)
+    int fifoSize = 0;              // Classifier window size
+    int hopSize = 0;               // Samples between windows, from the detection rate
+    std::atomic<int> requestedHopSize { 0 };
     int pos = 0;                   // Position in the FIFO buffer
-    int count = 0;                 // Tracks number of processed samples
+    int count = 0;                 // Tracks number of samples since the last hop
+    uint64_t samplesAppended = 0;  // Total written since prepareToPlay, i.e. the audio position
 
-    std::vector<float> inputFifo;      // Circular buffer for incoming samples
-    std::vector<float> outputFifo;  // Buffer for processing
-    
-    std::vector<float> classifierBuffer; // Buffer for processing
+    std::vector<float> inputFifo;        // Circular buffer of resampled samples
+    std::vector<float> classifierBuffer; // Linearised window (or log-mel patch) handed to the classifier
 
-    //std::array<float, 521> output_0; // Member container for output of classification model.
-    std::vector<float> output_0;  // Size based on expected output
-    
-    Ort::Env env;
-    Ort::Session onnxSession;
-    std::string model_path;
+    // Only fed when the shared service has loaded the backbone-only model
+    LogMelFrontend melFrontend;
+
+    // Silence gate. Gated chunks bypass the resampler and go into the ring as zeros, except for
+    // the stretch that a silence check will analyse; a window is gated when none of it came from
+    // ungated audio.
+    SilenceGate silenceGate;
+    bool resamplerIsIdle = false;      // Needs resetting before the next ungated chunk
+    double pendingSilentSamples = 0.0; // Fraction of a 16k sample carried between gated chunks
+    uint64_t soundEnd = 0;             // samplesAppended at the end of the last ungated audio
+    int gatedWindowsSinceCheck = 0;
+    std::atomic<int> windowsGated { 0 };
+    std::atomic<int> silenceChecksRun { 0 };
+    std::atomic<int> silenceChecksAgreed { 0 };
+    std::atomic<bool> gateReopened { false }; // Set by a failed check, cleared by the next loud chunk
+
+    static constexpr int silenceCheckInterval = 64;            // ~30 secs of continuous silence
+    static constexpr uint64_t silenceCheckTag = 1ull << 63;    // Marks windows submitted as checks
+
+    // Result reuse for steady audio. The reference is the last window submitted to the model; its
+    // result can be reused once it has come back (lastModelWindowEnd == referenceWindowEnd).
+    SpectralChangeDetector changeDetector;
+    std::atomic<float> reuseToleranceDb { 2.0f };
+    std::atomic<double> maxReuseAgeMs { 2000.0 };
+    std::atomic<int> windowsReused { 0 };
+    uint64_t referenceWindowEnd = 0;                                       // Guarded by publishLock
+    uint64_t lastModelWindowEnd = 0;                                       // Guarded by publishLock
+    std::array<float, ClassificationResult::numClasses> lastModelScores {}; // Guarded by publishLock
+
+    // Filled on the inference scheduler thread (or the worker, for gated windows) under
+    // publishLock, then published to the message thread
+    juce::CriticalSection publishLock;
+    TripleBuffer<ClassificationResult> results;
+    uint64_t nextSequence = 1;
+    ClassificationHistory history;
+    std::atomic<int> droppedWindows { 0 };
+
+    // Latency diagnostics: resampling on the worker, inference on the scheduler thread
+    LatencyHistogram resampleTimes;
+    LatencyHistogram inferenceLatencies;
+    std::atomic<int> windowsLate { 0 };
 
-    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    // Consumer-aware throttling
+    std::atomic<int> numConsumers { 0 };
+    std::atomic<InferenceMode> idleMode { InferenceMode::lowDuty };
+    std::atomic<int> lowDutyInterval { 8 }; // ~4 secs between results at the default hop
+    std::atomic<InferenceMode> currentMode { InferenceMode::full };
+    int hopsSinceSubmitted = 0;
+    std::atomic<int> windowsSubmitted { 0 };
+    std::atomic<int> windowsThrottled { 0 };
 
-    juce::File modelFile;
+    const double creationTimeMs = juce::Time::getMillisecondCounterHiRes();
+    std::atomic<double> timeToFirstScoreMs { 0.0 };
 
-    //std::atomic_flag outputLock = ATOMIC_FLAG_INIT; // Spinlock for output_0
+    // One Env and one session shared by every instance in the process
+    juce::SharedResourcePointer<InferenceService> inferenceService;
 };
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    ClassificationHistory.h
+    Created: 19 Oct 2026 2:05:48pm
+    Author:  William Wedgwood
+
+    A fixed-capacity ring of past results that outlives the editor, so a
+    reopened (or stalled) UI can catch up with "everything since sequence N"
+    instead of rebuilding its history from scratch. Stored column by column:
+    one array per field and one per label group, indexed by sequence number.
+
+    Written on the inference scheduler thread, read on the message thread.
+    Neither is the audio thread, so a short lock keeps the reader from seeing
+    a half-written row.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "LabelGroups.h"
+
+namespace score_packet
+{
+struct HistoryWriter;
+}
+
+class ClassificationHistory
+{
+public:
+    // 8.5 minutes at the default detection rate, 2 minutes at the fastest
+    static constexpr int capacity = 1024;
+
+    struct Columns
+    {
+        std::vector<uint64_t> sequences;
+        std::vector<uint64_t> audioPositions;   // 16k samples since prepareToPlay
+        std::vector<juce::int64> timesMs;        // Wall clock when the result was published
+        std::array<std::vector<float>, label_groups::numGroups> groupScores;
+
+        size_t size() const noexcept { return sequences.size(); }
+    };
+
+    // Scheduler thread. Sequences must arrive in increasing order.
+    void push(uint64_t sequence, uint64_t audioPosition, juce::int64 timeMs,
+              std::span<const float, label_groups::numGroups> groupScores);
+
+    // Message thread: every entry still held with a sequence above sinceSequence, oldest first
+    Columns getSince(uint64_t sinceSequence) const;
+
+    uint64_t getLatestSequence() const;
+
+private:
+    // Writes the UI's score packets straight from the ring, under the same lock
+    friend struct score_packet::HistoryWriter;
+
+    juce::CriticalSection lock;
+
+    std::array<uint64_t, capacity> sequences {};
+    std::array<uint64_t, capacity> audioPositions {};
+    std::array<juce::int64, capacity> timesMs {};
+    std::array<std::array<float, capacity>, label_groups::numGroups> groupScores {};
+
+    uint64_t latestSequence = 0;
+};
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    InferenceService.h
+    Created: 18 Oct 2026 11:20:45am
+    Author:  William Wedgwood
+
+    Process-wide owner of the ONNX Runtime environment and the YAMNet session.
+    Every AudioClassification holds a juce::SharedResourcePointer to it, so all
+    plugin instances in a host share one copy of the weights and one global
+    intra-op thread pool. It is created with the first instance and destroyed
+    with the last one.
+
+    The model is only loaded once an instance is actually prepared to play,
+    and then on the scheduler thread, so constructing the service (and with
+    it the plugin, e.g. during a host's plugin scan) never waits for ONNX
+    Runtime's graph optimiser. Until loading finishes the service reports
+    State::loading and rejects submissions.
+
+    If a backbone-only export (yamnet_backbone.onnx, taking a [96, 64] log-mel
+    patch) sits next to the full model, it is loaded instead and instances
+    compute the patch themselves with LogMelFrontend.
+
+    Instances don't run the model themselves: they submit 15360-sample windows
+    and a single scheduler thread gathers whatever arrives within the latency
+    budget into one batch. Results are handed back to each instance in the
+    order its windows were submitted.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <onnxruntime_cxx_api.h>
+#include <onnxruntime_session_options_config_keys.h>
+#include <array>
+#include <atomic>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "RealtimeLog.h"
+#include "Trace.h"
+
+class InferenceService : private juce::Thread
+{
+public:
+    InferenceService();
+    ~InferenceService() override;
+
+    static constexpr int64_t waveformLength = 15360; // 0.96 secs at 16k
+    static constexpr int64_t patchFrames = 96;       // 0.96 secs of 10 ms log-mel frames
+    static constexpr int64_t patchBands = 64;
+    static constexpr int64_t maxInputLength = waveformLength;
+    static constexpr int64_t numClasses = 521;
+    static constexpr int maxBatchSize = 16;
+
+    enum class State
+    {
+        loading,
+        ready,
+        failed
+    };
+
+    enum class InputKind
+    {
+        waveform,   // Full model: [15360] samples at 16k
+        logMelPatch // Backbone only: [96, 64] log-mel patch
+    };
+
+    //===============================================================================================
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Called on the scheduler thread, in the order the windows were submitted, with the tag
+        // the window was submitted with and the high-resolution tick count when it was.
+        virtual void inferenceCompleted(std::span<const float> scores, uint64_t tag, juce::int64 submissionTicks) = 0;
+    };
+
+    // Starts loading the model in the background; cheap to call more than once.
+    void startLoading();
+
+    // Where the models are looked for, <common application data>/Salsa/AQUA_v1 unless overridden.
+    // Set before the first instance starts loading, e.g. from a headless tool's command line.
+    static void setModelDirectory(const juce::File& newDirectory);
+    static juce::File getModelDirectory();
+
+    // Where optimised graphs are cached, <user application data>/Salsa/AQUA_v1/ModelCache unless
+    // overridden. Read each time a model loads, so a benchmark can start instances against an
+    // empty folder and then a populated one.
+    static void setModelCacheDirectory(const juce::File& newDirectory);
+    static juce::File getModelCacheDirectory();
+
+    // Analysis worker: copies the window (getInputLength() floats of whatever getInputKind()
+    // asks for) into the batch being gathered. Returns false (and drops the window) if the model
+    // isn't loaded or the scheduler is too far behind to accept it. The tag is handed back
+    // untouched with the result.
+    bool submit(Client& client, std::span<const float> input, uint64_t tag = 0);
+
+    // Drops the client's queued windows and waits for any in-flight result to be delivered.
+    // After this returns, inferenceCompleted() will not be called on the client again.
+    void removeClient(Client& client);
+
+    // How long the first window of a batch may wait for other instances to join it
+    void setLatencyBudgetMs(const double newBudgetMs) noexcept { latencyBudgetMs.store(newBudgetMs); }
+    double getLatencyBudgetMs() const noexcept { return latencyBudgetMs.load(); }
+
+    State getState() const noexcept { return state.load(std::memory_order_acquire); }
+    bool isReady() const noexcept { return getState() == State::ready; }
+
+    // Only meaningful once the service is ready
+    InputKind getInputKind() const noexcept { return inputKind; }
+    int64_t getInputLength() const noexcept { return inputKind == InputKind::waveform ? waveformLength : patchFrames * patchBands; }
+    bool supportsBatching() const noexcept { return batchedInput; }
+    double getModelLoadTimeMs() const noexcept { return modelLoadTimeMs.load(std::memory_order_relaxed); }
+
+    // Smoothed wall time ONNX Runtime spends per window, or 0 before the first batch
+    double getMeanWindowRunTimeMs() const noexcept { return meanWindowRunTimeMs.load(std::memory_order_relaxed); }
+
+    // Distribution of the wall time ONNX Runtime spends per window, across every instance
+    LatencyHistogram::Snapshot getRunTimeSnapshot() const noexcept { return runTimes.getSnapshot(); }
+    bool wasLoadedFromCache() const noexcept { return loadedFromCache; }
+
+private:
+    struct Batch
+    {
+        std::vector<float> inputs = std::vector<float>(maxBatchSize * maxInputLength);
+        std::vector<float> scores = std::vector<float>(maxBatchSize * numClasses);
+        std::array<Client*, maxBatchSize> clients {};
+        std::array<uint64_t, maxBatchSize> tags {};
+        std::array<juce::int64, maxBatchSize> submissionTicks {};
+        int size = 0;
+        double firstSubmissionMs = 0.0;
+
+        // Views over inputs and scores, created once when the model has loaded
+        std::vector<Ort::Value> tensors;
+        std::vector<Ort::IoBinding> bindings;
+    };
+
+    void run() override;
+    void loadModel();
+    void createSession();
+
+    // Optimised graphs are cached per user, keyed on the model hash, ORT version and CPU features
+    juce::File getOptimisedModelCacheFile() const;
+    static juce::String getCpuFeatureString();
+    static uint64_t hashFileContents(const juce::File& file);
+    static void evictLeastRecentlyUsedCacheFiles(const juce::File& cacheDirectory);
+    void prepareBindings(Batch& batch);
+    void runBatch(Batch& batch);
+    bool runBinding(Ort::IoBinding& binding);
+
+    static int getNumGlobalThreads();
+    static juce::File& getModelDirectoryOverride();
+    static juce::File& getModelCacheDirectoryOverride();
+
+    // Created and used on the scheduler thread only
+    Ort::Env env { nullptr };
+    Ort::Session session { nullptr };
+    std::string model_path;
+    std::string inputName;
+    std::string outputName;
+    InputKind inputKind = InputKind::waveform;
+    bool batchedInput = false; // The model takes a leading batch dimension
+    bool loadedFromCache = false;
+
+    std::atomic<State> state { State::loading };
+    std::atomic<double> modelLoadTimeMs { 0.0 };
+    std::atomic<double> meanWindowRunTimeMs { 0.0 };
+    LatencyHistogram runTimes;
+
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    Ort::RunOptions runOptions;
+
+    juce::File modelFile;
+
+    // Windows are gathered into one batch while the other one is being run
+    std::array<Batch, 2> batches;
+    Batch* gathering = &batches[0];
+    Batch* running = &batches[1];
+
+    juce::CriticalSection gatherLock;   // Protects *gathering and the swap
+    juce::CriticalSection deliveryLock; // Held while results are handed back to clients
+
+    std::atomic<double> latencyBudgetMs { 20.0 };
+
+    juce::CriticalSection startLock;
+
+    // Optimised graphs kept side by side, for other plugin builds, ORT versions and CPUs sharing
+    // the folder; beyond this the least recently used go
+    static constexpr int maxCachedModels = 4;
+
+    // Session creation can't be interrupted, so give a load in progress time to finish
+    static constexpr int schedulerStopTimeoutMs = 30000;
+
+    JUCE_DECLARE_NON_COPYABLE(InferenceService)
+};
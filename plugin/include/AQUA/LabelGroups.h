@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    LabelGroups.h
+    Created: 19 Oct 2026 9:12:37am
+    Author:  William Wedgwood
+
+    The groups the UI shows (Rain, Wind, Hum, ...) and the YAMNet classes that
+    make up each one. A group's score is the highest score among its classes.
+    The order here is the order of ClassificationLabels in the React UI's
+    constants.js, which is how the UI names each group score it receives.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <span>
+
+namespace label_groups
+{
+struct LabelGroup
+{
+    const char* name;
+    int firstIndex; // Into classIndices
+    int numIndices;
+};
+
+// Every group's YAMNet class indices, back to back
+inline constexpr std::array<int, 41> classIndices {
+    282, 283, 284, 285, 286, 438, 439, 442, 443, 444, 445, 446, // Rain
+    36, 40, 190, 277, 278, 279, 453,                            // Wind
+    27, 61, 62, 64,                                             // Crowd
+    0, 1, 2, 3, 4,                                              // Speech
+    6, 7, 9, 11,                                                // Shout
+    132,                                                        // Music (Tannoy)
+    494,                                                        // Silence
+    506,                                                        // Echo
+    509,                                                        // Static
+    511,                                                        // Distortion
+    514,                                                        // White Noise
+    515,                                                        // Pink Noise
+    495,                                                        // Sine Wave
+    510                                                         // Hum
+};
+
+inline constexpr std::array<LabelGroup, 14> groups {{
+    {"Rain", 0, 12},
+    {"Wind", 12, 7},
+    {"Crowd", 19, 4},
+    {"Speech", 23, 5},
+    {"Shout", 28, 4},
+    {"Music (Tannoy)", 32, 1},
+    {"Silence", 33, 1},
+    {"Echo", 34, 1},
+    {"Static", 35, 1},
+    {"Distortion", 36, 1},
+    {"White Noise", 37, 1},
+    {"Pink Noise", 38, 1},
+    {"Sine Wave", 39, 1},
+    {"Hum", 40, 1},
+}};
+
+inline constexpr size_t numGroups = groups.size();
+inline constexpr int silenceGroup = 6;
+inline constexpr int silenceClassIndex = 494;
+
+// Gather-max of the 521 class scores into one score per group
+void reduce(std::span<const float> scores, std::span<float, numGroups> groupScores) noexcept;
+}  // namespace label_groups
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    LatencyHistogram.h
+    Created: 21 Oct 2026 11:03:27am
+    Author:  William Wedgwood
+
+    HDR-style histogram of durations in microseconds. Values below 32 us get a
+    bucket each; above that, every power of two is split into 32 linear
+    buckets, so any recorded value is known to within about 3% all the way up
+    to maxTrackableUs. Larger values are clamped into the top bucket (the
+    exact maximum is still kept).
+
+    Recording is a handful of relaxed atomic increments: it never locks or
+    allocates, and several threads may record at once. Snapshots can be
+    taken from any thread while recording carries on; they may be a few
+    values behind, never torn in a way that matters for a display.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+class LatencyHistogram
+{
+public:
+    static constexpr uint32_t maxTrackableUs = (1u << 26) - 1; // ~67 secs
+
+    // Any thread
+    void record(juce::int64 startTicks, juce::int64 endTicks) noexcept;
+    void recordMicroseconds(uint32_t valueUs) noexcept;
+
+    // Only while nothing is recording, e.g. from prepareToPlay with the worker stopped
+    void reset() noexcept;
+
+    struct Snapshot
+    {
+        uint64_t count = 0;
+        double meanMs = 0.0;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double p999Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Any thread. Percentiles are the upper edge of the bucket they fall in.
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    static constexpr int subBucketBits = 5;
+    static constexpr uint32_t subBucketCount = 1u << subBucketBits;
+    static constexpr int numBuckets = (26 - subBucketBits + 1) * static_cast<int>(subBucketCount);
+
+    static int getBucketIndex(uint32_t valueUs) noexcept;
+    static uint32_t getBucketUpperEdge(int index) noexcept;
+
+    std::array<std::atomic<uint32_t>, numBuckets> buckets {};
+    std::atomic<uint64_t> count { 0 };
+    std::atomic<uint64_t> totalUs { 0 };
+    std::atomic<uint32_t> maxUs { 0 };
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    LogMelFrontend.h
+    Created: 18 Oct 2026 4:05:52pm
+    Author:  William Wedgwood
+
+    Incremental C++ version of YAMNet's feature extractor: 25 ms periodic Hann
+    frames every 10 ms at 16k, 512-point magnitude spectrum, 64 HTK mel bands
+    from 125 Hz to 7.5 kHz and log(mel + 0.001). Each frame is computed once,
+    as its samples arrive, and kept in a rolling 96-frame patch, which is the
+    input of the backbone-only model. With 50% hop overlap this halves the
+    spectral work compared with letting the full model recompute every frame
+    of every window.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include <span>
+#include <vector>
+
+class LogMelFrontend
+{
+public:
+    static constexpr int frameLength = 400;  // 25 ms at 16k
+    static constexpr int frameHop = 160;     // 10 ms at 16k
+    static constexpr int fftOrder = 9;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numMelBands = 64;
+    static constexpr int numPatchFrames = 96; // 0.96 secs
+    static constexpr int patchSize = numPatchFrames * numMelBands;
+
+    LogMelFrontend();
+
+    void reset();
+
+    // Analysis worker: feed 16k samples as they arrive.
+    void pushSamples(std::span<const float> samples);
+
+    // Copies the last numPatchFrames frames, oldest first, as a [96, 64] patch.
+    void copyPatch(std::span<float> destination) const;
+
+    // True once a full patch of real frames has been computed since the last reset
+    bool hasFullPatch() const noexcept { return numFramesSinceReset >= numPatchFrames; }
+
+private:
+    struct MelBand
+    {
+        int firstBin = 0;
+        std::vector<float> weights; // Only the non-zero part of the triangle
+    };
+
+    void computeFrame();
+    static double hertzToMel(const double frequency);
+
+    juce::dsp::FFT fft { fftOrder };
+
+    std::vector<float> window;       // Periodic Hann, frameLength long
+    std::vector<MelBand> melBands;
+    std::vector<float> fftBuffer;    // 2 * fftSize, as juce::dsp::FFT requires
+
+    // Last frameLength samples, circular
+    std::vector<float> sampleRing;
+    int sampleWritePos = 0;
+    int samplesUntilNextFrame = frameLength;
+
+    // Last numPatchFrames log-mel frames, circular
+    std::vector<float> patchRing;
+    int patchWriteFrame = 0;
+    int numFramesSinceReset = 0;
+
+    static constexpr float logOffset = 0.001f;
+    static constexpr double melMinHz = 125.0;
+    static constexpr double melMaxHz = 7500.0;
+    static constexpr double sampleRate = 16000.0;
+};
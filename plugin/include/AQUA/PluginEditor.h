@@ -8,6 +8,7 @@
 namespace webview_plugin {
 
 class AudioPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                        private juce::ChangeListener,
                                         private juce::Timer {
 public:
   explicit AudioPluginAudioProcessorEditor(AudioPluginAudioProcessor&);
@@ -16,19 +17,55 @@ public:
   void resized() override;
 
   void timerCallback() override;
+  void visibilityChanged() override;
 
 private:
+  void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+  // Sends the latest result to the UI if it (or the analysis state) is new
+  void emitLatestResult();
+
+  // The editor only counts as a consumer of results while it's on screen
+  void updateConsumerRegistration();
+
   using Resource = juce::WebBrowserComponent::Resource;
   std::optional<Resource> getResource(const juce::String& url) const;
 
+  // Every held result newer than sinceSequence as a score packet, for the
+  // UI's yamnetOut.bin fetches when it opens or has missed a pushed result
+  std::vector<std::byte> getHistorySince(uint64_t sinceSequence) const;
+
+  // CPU load, latency percentiles and window counters for the UI's
+  // getDiagnostics native function
+  juce::var getDiagnostics() const;
+
+  // Writes the trace events recorded so far to a new file under the user's
+  // application data, for the saveTrace native function. Returns the file's
+  // path, or an empty string if tracing is compiled out or the write failed.
+  juce::String saveTrace() const;
+
   void nativeFunction(
       const juce::Array<juce::var>& args,
       juce::WebBrowserComponent::NativeFunctionCompletion completion);
 
   AudioPluginAudioProcessor& processorRef;
 
+  // Cold-open timing: editor construction until the UI's page is served
+  const double openStartMs = juce::Time::getMillisecondCounterHiRes();
+  mutable bool hasLoggedOpenTime = false;
+
   juce::WebBrowserComponent webView;
 
+  uint64_t lastEmittedSequence = 0;
+  std::optional<AnalysisState> lastEmittedState;
+
+  bool isConsumingResults = false;
+
+  // Results are pushed as they arrive; this only catches state changes that
+  // don't come with a result (warm-up ending in failure) and the window being
+  // hidden or minimised
+  static constexpr int statePollIntervalMs = 500;
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessorEditor)
 };
 }  // namespace webview_plugin
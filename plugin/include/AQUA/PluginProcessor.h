@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "AudioClassification.h"
+#include "RealtimeLog.h"
 
 namespace webview_plugin {
 class AudioPluginAudioProcessor : public juce::AudioProcessor {
@@ -51,22 +52,43 @@ public:
     return *parameters.distortionType;
   }
 
-    // Send classification message to editor
-    AudioClassification& getAudioClassification() { return audioClassifier; }
+  // Send classification message to editor
+  AudioClassification& getAudioClassification() { return audioClassifier; }
+
+  // Wall-clock time the constructor took, excluding the (deferred) model load
+  double getInstantiationTimeMs() const noexcept { return instantiationTimeMs; }
+
+  // processBlock's smoothed share of the time each block represents, and the
+  // blocks that took longer than that, since prepareToPlay
+  [[nodiscard]] double getCpuLoad() const {
+    return loadMeasurer.getLoadAsProportion();
+  }
+  [[nodiscard]] int getNumOverruns() const {
+    return loadMeasurer.getXRunCount();
+  }
 
 private:
   struct Parameters {
     juce::AudioParameterFloat* gain{nullptr};
     juce::AudioParameterBool* bypass{nullptr};
     juce::AudioParameterChoice* distortionType{nullptr};
+    juce::AudioParameterFloat* detectionRate{nullptr};
   };
 
   [[nodiscard]] static juce::AudioProcessorValueTreeState::ParameterLayout
   createParameterLayout(Parameters&);
 
+  const double constructionStartMs = juce::Time::getMillisecondCounterHiRes();
+  double instantiationTimeMs = 0.0;
+
+  // Declared before the classifier so its final flush catches the classifier's last messages
+  juce::SharedResourcePointer<RealtimeLog::Drainer> logDrainer;
+
   Parameters parameters;
   juce::AudioProcessorValueTreeState state;
 
+  juce::AudioProcessLoadMeasurer loadMeasurer;
+
   // ========= Audio Classification ======
   bool audioClassification;
   AudioClassification audioClassifier;
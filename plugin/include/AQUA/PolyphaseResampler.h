@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.h
+    Created: 18 Oct 2026 2:41:09pm
+    Author:  William Wedgwood
+
+    Streaming rational resampler for host rates that have an exact L/M ratio
+    to the target rate (44.1k -> 16k is 160/441, 48k -> 16k is 1/3, 96k -> 16k
+    is 1/6). The Kaiser-windowed lowpass is split into L polyphase filter banks
+    when prepared, so each output sample is one SIMD dot product over
+    tapsPerPhase input samples.
+
+    The passband is tuned for the classifier front end rather than for
+    listening: flat to 0.47 of the lower rate, with aliases folding no lower
+    than that (YAMNet's mel bank stops at 7.5k of the 8k Nyquist).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <span>
+#include <vector>
+
+class PolyphaseResampler
+{
+public:
+    // True if the rates reduce to an L/M whose filter bank is small enough to precompute
+    static bool supportsRates(const double inputSampleRate, const double outputSampleRate);
+
+    void prepare(const double inputSampleRate, const double outputSampleRate);
+    void reset();
+
+    // Same contract as SampleRateConversion::interpolateAudio
+    int process(std::span<const float> input, std::span<float> output);
+    int getMaxOutputSamples(const int numInputSamples) const;
+
+    int getUpFactor() const noexcept { return upFactor; }
+    int getDownFactor() const noexcept { return downFactor; }
+    int getTapsPerPhase() const noexcept { return tapsPerPhase; }
+
+private:
+    static float dotProduct(const float* a, const float* b, const int numSamples) noexcept;
+    static double besselI0(const double x);
+
+    static constexpr int maxUpFactor = 160;
+    static constexpr int maxBlockSize = 4096;
+    static constexpr double stopbandAttenuationDb = 80.0;
+
+    int upFactor = 1;   // L
+    int downFactor = 1; // M
+    int tapsPerPhase = 0;
+
+    // upFactor banks of tapsPerPhase coefficients, each stored time-reversed so it lines up with
+    // the input history, and padded to a multiple of 8 floats for the SIMD loop
+    std::vector<float> coefficients;
+
+    std::vector<float> history; // tapsPerPhase - 1 samples of history followed by new input
+    int numBuffered = 0;
+    int inputIndex = 0;         // Newest input sample used by the next output
+    int phase = 0;              // Position of the next output between inputs, in 1/L steps
+};
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.h
+    Created: 18 Oct 2026 4:12:37pm
+    Author:  William Wedgwood
+
+    Process-wide log that any thread, including the audio thread, can post to.
+    Messages are formatted straight into a preallocated slot of a fixed-size
+    multi-producer queue, so posting never allocates, locks or makes a syscall;
+    if the queue is full the message is dropped and counted. The message thread
+    drains the queue into juce::Logger (install a juce::FileLogger to send it to
+    a file), holding back repeats of the same message so an error raised every
+    hop can't flood the host's log.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_events/juce_events.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+class RealtimeLog
+{
+public:
+    enum class Level : uint8_t { info, error };
+
+    static constexpr uint32_t capacity = 256;           // Power of two, so positions wrap cleanly
+    static constexpr size_t maxMessageLength = 256;     // Longer messages are truncated
+
+    // Repeats of a message beyond this many per interval are counted rather than written
+    static constexpr int maxRepeatsPerInterval = 3;
+    static constexpr double repeatIntervalMs = 10000.0;
+
+    // ===== Any thread =====
+    // printf-style; the format must be a string literal, which also identifies the call site
+    // for rate limiting.
+    template <typename... Args>
+    static void info(const char* format, Args... args) noexcept { post(Level::info, format, args...); }
+
+    template <typename... Args>
+    static void error(const char* format, Args... args) noexcept { post(Level::error, format, args...); }
+
+    template <typename... Args>
+    static void post(Level level, const char* format, Args... args) noexcept
+    {
+        auto& log = getInstance();
+        auto* slot = log.beginWrite();
+
+        if (slot == nullptr)
+            return;
+
+        slot->level = level;
+        slot->format = format;
+        slot->timeMs = juce::Time::getMillisecondCounter();
+
+        if constexpr (sizeof...(Args) == 0)
+        {
+            std::strncpy(slot->text.data(), format, slot->text.size() - 1);
+            slot->text.back() = '\0';
+        }
+        else
+        {
+            std::snprintf(slot->text.data(), slot->text.size(), format, args...);
+        }
+
+        log.endWrite(*slot);
+    }
+
+    static uint64_t getNumDroppedMessages() noexcept;
+    static uint64_t getNumSuppressedMessages() noexcept;
+
+    // ===== Message thread =====
+    // Writes everything queued so far. Called by Drainer; anything without a message loop
+    // (a headless host, say) can call it directly.
+    static void flush();
+
+    // flush(), then writes out every repeat count still held back, whether or not its interval
+    // is over. For shutdown, so a burst's count isn't lost with the process.
+    static void flushAll();
+
+    // Drains the log on a timer for as long as one exists; hold one in a
+    // juce::SharedResourcePointer from each plugin instance.
+    class Drainer : private juce::Timer
+    {
+    public:
+        Drainer();
+        ~Drainer() override;
+
+    private:
+        void timerCallback() override;
+
+        static constexpr int flushIntervalMs = 100;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Drainer)
+    };
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence { 0 };
+        uint32_t publishedSequence = 0;
+        Level level = Level::info;
+        uint32_t timeMs = 0;
+        const char* format = nullptr;
+        std::array<char, maxMessageLength> text {};
+    };
+
+    struct RepeatState
+    {
+        double intervalStartMs = 0.0;
+        int numWritten = 0;
+        int numHeldBack = 0;
+        Level level = Level::info;
+        juce::String lastHeldBack; // The most recent of the held-back messages
+    };
+
+    RealtimeLog() noexcept;
+
+    static RealtimeLog& getInstance() noexcept;
+
+    Slot* beginWrite() noexcept;
+    void endWrite(Slot& slot) noexcept;
+    void flushQueue();
+    void flushRepeats(bool includeOpenIntervals);
+    void write(Level level, const juce::String& message);
+    void writeRepeatCount(const RepeatState& repeat);
+
+    std::array<Slot, capacity> slots;
+
+    alignas(64) std::atomic<uint32_t> enqueuePosition { 0 };
+    alignas(64) std::atomic<uint64_t> numDropped { 0 };
+    std::atomic<uint64_t> numSuppressed { 0 };
+
+    // Consumer side, guarded by flushLock
+    juce::CriticalSection flushLock;
+    uint32_t dequeuePosition = 0;
+    uint64_t numDroppedReported = 0;
+    std::unordered_map<const char*, RepeatState> repeats;
+};
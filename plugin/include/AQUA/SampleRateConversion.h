@@ -15,22 +15,51 @@
 #include <samplerate.h> // For libsamplerate (SRC)
 #include <span>
 
+#include "PolyphaseResampler.h"
+#include "RealtimeLog.h"
+
+// Uses the native PolyphaseResampler when the rates have an exact small ratio (all the common
+// host rates to 16k), and libsamplerate for anything else.
 class SampleRateConversion
 {
     public:
         SampleRateConversion();
         ~SampleRateConversion();
     
-        void prepareToPlay(const int inBufferSize, const int outBufferSize);
+        // automatic picks the polyphase resampler where it can and libsamplerate's best sinc
+        // elsewhere; the others always use libsamplerate, e.g. to compare against it
+        enum class Quality
+        {
+            automatic,
+            sincBest,
+            sincMedium,
+            sincFastest
+        };
+
+        void prepareToPlay(const double inputSampleRate, const double outputSampleRate, const Quality quality = Quality::automatic);
         void releaseResources();
 
-        void interpolateAudio(const std::span<float>& inputBuffer, std::span<float>& outputBuffer);
+        // Clears the filter history, as if everything fed in so far had been silence
+        void reset();
+
+        // Streams inputBuffer through the converter, keeping the filter state between calls, and
+        // returns the number of samples written to outputBuffer. outputBuffer must have room for
+        // getMaxOutputSamples(inputBuffer.size()).
+        int interpolateAudio(std::span<const float> inputBuffer, std::span<float> outputBuffer);
+
+        int getMaxOutputSamples(const int numInputSamples) const;
+
+        bool isUsingPolyphase() const noexcept { return usePolyphase; }
+        double getRatio() const noexcept { return resampleRatio; }
     
     private:
+        PolyphaseResampler polyphase;
+        bool usePolyphase = false;
+
         SRC_STATE* resampleState;
         int resampleError;
     
         SRC_DATA srcData;
     
-        double resampleRatio; // The exact resampleRatio has to be calculated based on the input/output size
+        double resampleRatio; // Output rate / input rate
 };
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    ScorePacket.h
+    Created: 19 Oct 2026 11:40:02am
+    Author:  William Wedgwood
+
+    The binary form of a run of ClassificationHistory rows that the WebView
+    fetches from yamnetOut.bin/<N> (every held result after sequence N) when
+    it opens or finds it has missed a pushed result. The sequence is part of
+    the path because not every WebView backend passes a query string through
+    to the resource provider. Stored column by column, like the history.
+    Everything is little-endian:
+
+        offset  0  uint32  AnalysisState
+        offset  4  uint32  number of label groups, G
+        offset  8  uint32  number of results, N
+        offset 12  uint32  reserved, 0
+        offset 16  uint64  N sequences, oldest first
+                   uint64  N audio positions of the window ends, in 16k samples
+                   int64   N wall-clock publish times, in ms
+                   float32 G columns of N group scores, in label_groups::groups order
+
+    Every column starts 8-byte aligned (the float columns at least 4), so JS
+    can view each one as a typed array over the same buffer without copying.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "AudioClassification.h"
+
+namespace score_packet
+{
+inline constexpr size_t headerSize = 16;
+
+constexpr size_t getPacketSize(size_t numResults) noexcept
+{
+    return headerSize + numResults * (3 * sizeof(uint64_t) + label_groups::numGroups * sizeof(float));
+}
+
+// Every entry the history still holds above sinceSequence, written straight from its ring into a
+// packet sized in one allocation, so each value is copied once
+std::vector<std::byte> write(const ClassificationHistory& history, uint64_t sinceSequence, AnalysisState state);
+}  // namespace score_packet
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    SilenceGate.h
+    Created: 20 Oct 2026 10:18:52am
+    Author:  William Wedgwood
+
+    Decides whether a stretch of audio is quiet enough to skip resampling and
+    inference altogether. A block counts as silent when both its peak and its
+    RMS level sit below their thresholds.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <span>
+
+class SilenceGate
+{
+public:
+    struct Level
+    {
+        float peak = 0.0f;
+        float rms = 0.0f;
+    };
+
+    // Peak and RMS of the block in one pass, vectorised where the platform allows
+    static Level measure(std::span<const float> samples) noexcept;
+
+    // Any thread
+    void setThresholdsDb(float peakDb, float rmsDb) noexcept;
+    float getPeakThresholdDb() const noexcept { return juce::Decibels::gainToDecibels(peakThreshold.load(std::memory_order_relaxed)); }
+    float getRmsThresholdDb() const noexcept { return juce::Decibels::gainToDecibels(rmsThreshold.load(std::memory_order_relaxed)); }
+
+    bool isSilent(const Level& level) const noexcept
+    {
+        return level.peak < peakThreshold.load(std::memory_order_relaxed)
+            && level.rms < rmsThreshold.load(std::memory_order_relaxed);
+    }
+
+private:
+    static float sumOfSquares(const float* samples, int numSamples) noexcept;
+
+    // Defaults sit well under any real programme material but above dither and a quiet noise floor
+    std::atomic<float> peakThreshold { juce::Decibels::decibelsToGain(-50.0f) };
+    std::atomic<float> rmsThreshold { juce::Decibels::decibelsToGain(-60.0f) };
+};
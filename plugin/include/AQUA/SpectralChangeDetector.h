@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    SpectralChangeDetector.h
+    Created: 20 Oct 2026 2:47:15pm
+    Author:  William Wedgwood
+
+    A coarse spectrum of each 16k window (16 log-spaced bands from 62.5 Hz to
+    8 kHz, averaged over the window), used to tell when the audio has barely
+    changed since the last window the model actually saw. Steady material like
+    hum, pink noise or rain then reuses that result instead of running YAMNet
+    again.
+
+    Each hop is analysed once, as its samples arrive, with non-overlapping
+    512-point frames, so a window's spectrum is just the mean of the hops that
+    make it up.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <span>
+#include <vector>
+
+class SpectralChangeDetector
+{
+public:
+    static constexpr int fftOrder = 9;
+    static constexpr int fftSize = 1 << fftOrder; // 32 ms at 16k
+    static constexpr int numBands = 16;
+    static constexpr int maxHopsPerWindow = 8;
+
+    SpectralChangeDetector();
+
+    void reset();
+
+    // How many of the most recent hops make up a window (2 at 50% overlap)
+    void setHopsPerWindow(int newHopsPerWindow) noexcept { hopsPerWindow = juce::jlimit(1, maxHopsPerWindow, newHopsPerWindow); }
+
+    // Analysis worker: feed 16k samples as they arrive, then close each hop with endHop().
+    void pushSamples(std::span<const float> samples);
+    void endHop();
+
+    // Largest difference of any band, in dB, between the latest window and the reference, so a
+    // new sound confined to one band still counts as a change. Infinite if there's no reference.
+    float getDistanceFromReferenceDb() const noexcept;
+
+    void setReferenceToLatestWindow() noexcept;
+    void clearReference() noexcept { hasReference = false; }
+
+private:
+    void computeFrame();
+
+    juce::dsp::FFT fft { fftOrder };
+
+    std::vector<float> window;    // Hann, fftSize long
+    std::vector<float> fftBuffer; // 2 * fftSize, as juce::dsp::FFT requires
+    std::array<int, numBands + 1> bandEdges {}; // FFT bins; band b is [edge b, edge b+1)
+
+    std::vector<float> frame;
+    int frameFill = 0;
+
+    // Band power summed over the frames of the hop in progress, and of the last few complete hops
+    std::array<float, numBands> currentHopPower {};
+    int currentHopFrames = 0;
+    std::array<std::array<float, numBands>, maxHopsPerWindow> hopPower {};
+    std::array<int, maxHopsPerWindow> hopFrames {};
+    int nextHop = 0;
+    int hopsPerWindow = 2;
+
+    std::array<float, numBands> latestWindowDb {};
+    std::array<float, numBands> referenceDb {};
+    bool hasReference = false;
+};
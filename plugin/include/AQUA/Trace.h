@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    Trace.h
+    Created: 18 Oct 2026 7:02:26pm
+    Author:  William Wedgwood
+
+    Scoped trace zones for the hot paths, exported as a Chrome trace that
+    Perfetto (ui.perfetto.dev) or chrome://tracing can open.
+
+    Zones only exist in builds configured with AQUA_ENABLE_TRACING, which
+    defines AQUA_TRACING=1; otherwise the macros expand to nothing. Each thread
+    records into a fixed-size ring of its own, claimed on its first zone, so
+    recording never locks, allocates or waits on another thread. A ring keeps
+    the most recent events, overwriting the oldest, so a capture taken just
+    after an xrun shows what led up to it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef AQUA_TRACING
+ #define AQUA_TRACING 0
+#endif
+
+namespace trace
+{
+inline constexpr bool isEnabled = AQUA_TRACING != 0;
+
+// Message thread (or any non-realtime thread): writes every event recorded since the last call
+// to a Chrome trace JSON file. Returns false if tracing is compiled out or the file can't be written.
+bool writeChromeTrace(const juce::File& file);
+
+#if AQUA_TRACING
+// Any thread: the name must be a string literal, it's stored as a pointer
+void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+// Names the calling thread in the trace, for threads that aren't juce::Threads (the host's
+// audio thread, say). Only the first call on a thread has any effect.
+void setThreadName(const char* name) noexcept;
+
+class Zone
+{
+public:
+    explicit Zone(const char* zoneName) noexcept
+        : name(zoneName), startTicks(juce::Time::getHighResolutionTicks())
+    {
+    }
+
+    ~Zone() { record(name, startTicks, juce::Time::getHighResolutionTicks()); }
+
+private:
+    const char* name;
+    juce::int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE(Zone)
+};
+#endif
+} // namespace trace
+
+#if AQUA_TRACING
+ #define AQUA_TRACE_ZONE(name) const trace::Zone JUCE_JOIN_MACRO(traceZone_, __LINE__)(name)
+ #define AQUA_TRACE_THREAD_NAME(name) trace::setThreadName(name)
+#else
+ #define AQUA_TRACE_ZONE(name)
+ #define AQUA_TRACE_THREAD_NAME(name)
+#endif
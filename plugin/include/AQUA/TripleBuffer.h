@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 18 Oct 2026 10:02:11am
+    Author:  William Wedgwood
+
+    Wait-free hand-over of a fixed-size value from one producer thread to one
+    consumer thread. The producer fills the back buffer and publishes it; the
+    consumer picks up the most recently published buffer. Neither side ever
+    blocks, allocates or sees a half-written value. Intermediate values are
+    skipped if the producer publishes faster than the consumer reads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer
+{
+public:
+    // ===== Producer thread =====
+    T& getWriteBuffer() noexcept { return buffers[backIndex]; }
+
+    void publish() noexcept
+    {
+        const auto previous = middle.exchange(static_cast<uint8_t>(backIndex | dirtyBit), std::memory_order_acq_rel);
+        backIndex = previous & indexMask;
+    }
+
+    // ===== Consumer thread =====
+    // Returns true if a newer value was swapped in since the last call.
+    bool update() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & dirtyBit) == 0)
+            return false;
+
+        const auto previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return buffers[frontIndex]; }
+
+private:
+    static constexpr uint8_t indexMask = 0x3;
+    static constexpr uint8_t dirtyBit = 0x4;
+
+    std::array<T, 3> buffers {};
+
+    alignas(64) uint8_t backIndex = 0;          // Owned by the producer
+    alignas(64) std::atomic<uint8_t> middle { 1 };  // Shared; carries the dirty bit
+    alignas(64) uint8_t frontIndex = 2;         // Owned by the consumer
+};
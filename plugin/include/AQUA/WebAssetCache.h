@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    WebAssetCache.h
+    Created: 19 Oct 2026 4:31:10pm
+    Author:  William Wedgwood
+
+    The React UI's files, unzipped once per process from the embedded
+    webview_files.zip and looked up by path. Every editor shares the same
+    decompressed buffers, so reopening the editor doesn't touch the zip again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class WebAssetCache
+{
+public:
+    struct Asset
+    {
+        std::vector<std::byte> bytes;
+        const char* mimeType;
+    };
+
+    // Built on first use; safe to call from any thread
+    static const WebAssetCache& getInstance();
+
+    // Accepts the path as the resource provider sees it ("index.html", "/assets/x.js?v=1", ...).
+    // Returns nullptr if the UI has no such file.
+    std::shared_ptr<const Asset> find(std::string_view path) const;
+
+    size_t getNumAssets() const noexcept { return numAssets; }
+    double getBuildTimeMs() const noexcept { return buildTimeMs; }
+
+private:
+    WebAssetCache();
+
+    static std::string normalise(std::string_view path);
+
+    // Zip entries carry whatever directory prefix they were zipped with, so each one is reachable
+    // by every trailing part of its path ("dist/assets/x.js", "assets/x.js", "x.js")
+    std::unordered_map<std::string, std::shared_ptr<const Asset>> assets;
+    size_t numAssets = 0;
+    double buildTimeMs = 0.0;
+};
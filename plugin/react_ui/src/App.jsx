@@ -1,13 +1,21 @@
-import { useEffect, useState } from 'react';
+import { useEffect, useRef, useState } from 'react';
 import { AudioClassificationGraph } from './components/AudioClassificationGraph';
 import { ConfidenceTrackingGraph } from './components/ConfidenceTrackingGraph';
 import { ClassificationLabels } from './constants/constants';
 import { LabelDropdown } from './components/LabelDropdown';
-import { convertScoresToClassifications, convertScoresToConfidence } from './utils/dataHandler';
+import { DiagnosticsPanel } from './components/DiagnosticsPanel';
+import {
+  appendWithinWindow,
+  convertScoresToClassifications,
+  convertScoresToConfidence,
+  parseScorePacket
+} from './utils/dataHandler';
 import ThresholdSlider from './components/ThresholdSlider';
 import * as Juce from "./juce/index.js";
 import './styles/App.css';
 
+const HISTORY_WINDOW_MS = 60000;
+
 function App() {
   // ----------------------------
   // State Management
@@ -16,8 +24,10 @@ function App() {
   const [confidenceData, setConfidenceData] = useState([]);          // Confidence tracking data
   const [removedLabels, setRemovedLabels] = useState([]);            // Labels to hide from graphs
   const [connectionStatus, setConnectionStatus] = useState('connecting');
+  const [analysisStatus, setAnalysisStatus] = useState('warmingUp');   // Model state reported by the plugin
   const [threshold, setThreshold] = useState(0.5);                   // Classification threshold
   const [graphType, setGraphType] = useState('confidence');          // Active graph view type
+  const lastSequence = useRef(0);                                    // Newest result already plotted
   
   // Available classification labels
   const labels = Object.values(ClassificationLabels);
@@ -29,41 +39,89 @@ function App() {
     let isMounted = true;
     let juceEventListener = null;
 
-    // Handle incoming YAMNet data
-    const handleYamnetData = async () => {
-      try {
-        const response = await fetch(Juce.getBackendResourceAddress("yamnetOut.json"));
-        if (!response.ok) throw new Error('Network response was not ok');
-        
-        const yamnetOut = await response.text();
-        const yamnetOutput = JSON.parse(yamnetOut);
-        const currentTime = Date.now();
+    // Turn results (oldest first) into graph points and append them in one update each
+    const appendResults = (results) => {
+      if (!isMounted || results.length === 0) return;
 
-        // Process classification data with current threshold
-        const newClassifications = convertScoresToClassifications(yamnetOutput.scores, threshold)
+      const newClassifications = results.flatMap(({ time, groups }) =>
+        convertScoresToClassifications(groups, threshold, time)
           .map(({ label, value }) => ({
-            id: `${currentTime}-${label}`,
-            timestamp: currentTime,
+            id: `${time}-${label}`,
+            timestamp: time,
             label,
             value
-          }));
-
-        // Update confidence tracking data with 60-second window
-        setConfidenceData(prevConfidenceData =>
-          convertScoresToConfidence(yamnetOutput.scores, prevConfidenceData, 60000)
-        );
-
-        if (isMounted) {
-          // Update classifications with 60-second window
-          setClassifications(prev => [
-            ...prev.filter(d => d.timestamp >= currentTime - 60000),
-            ...newClassifications
-          ]);
-          setConnectionStatus('connected');
+          })));
+
+      const newConfidenceData = results.flatMap(({ time, groups }) =>
+        convertScoresToConfidence(groups, time));
+
+      // Keep a 60-second window ending at the newest result
+      setClassifications(prev => appendWithinWindow(prev, newClassifications, HISTORY_WINDOW_MS));
+      setConfidenceData(prev => appendWithinWindow(prev, newConfidenceData, HISTORY_WINDOW_MS));
+      setConnectionStatus('connected');
+    };
+
+    // Ask the plugin for everything after the newest result we've plotted. It keeps the
+    // history, so one binary packet fills the graphs on reopen and covers any results
+    // whose events were missed (coalesced while the message thread was busy, or stalled).
+    let isFetching = false;
+    let fetchAgain = false;
+
+    const catchUp = async () => {
+      // One fetch at a time; a gap noticed mid-fetch just triggers one more
+      if (isFetching) {
+        fetchAgain = true;
+        return;
+      }
+
+      isFetching = true;
+
+      try {
+        const response = await fetch(Juce.getBackendResourceAddress(`yamnetOut.bin/${lastSequence.current}`));
+        if (!response.ok) throw new Error('Network response was not ok');
+
+        const history = parseScorePacket(await response.arrayBuffer());
+        if (!isMounted) return;
+
+        setAnalysisStatus(history.status);
+        const added = history.results.filter(({ sequence }) => sequence > lastSequence.current);
+        if (added.length === 0) return;
+
+        lastSequence.current = added[added.length - 1].sequence;
+        appendResults(added);
+      } catch (error) {
+        console.error("History fetch error:", error);
+        if (isMounted) setConnectionStatus('disconnected');
+      } finally {
+        isFetching = false;
+        if (fetchAgain && isMounted) {
+          fetchAgain = false;
+          catchUp();
         }
+      }
+    };
+
+    // Each "yamnetOut" event carries the new result (or just a new analysis state)
+    const handleYamnetData = (yamnetOutput) => {
+      try {
+        if (!isMounted) return;
+        setAnalysisStatus(yamnetOutput.status);
+
+        // Nothing to plot until the plugin has published its first result
+        if (!yamnetOutput.sequence || yamnetOutput.sequence <= lastSequence.current) return;
+
+        // The next result in order is plotted as it came; anything else means results were
+        // missed, so fetch them all (this one included) from the history
+        if (isFetching || yamnetOutput.sequence !== lastSequence.current + 1) {
+          catchUp();
+          return;
+        }
+
+        lastSequence.current = yamnetOutput.sequence;
+        appendResults([yamnetOutput]);
       } catch (error) {
         console.error("Data processing error:", error);
-        if (isMounted) setConnectionStatus('disconnected');
+        setConnectionStatus('disconnected');
       }
     };
 
@@ -76,6 +134,7 @@ function App() {
             handleYamnetData
           );
           setConnectionStatus('connected');
+          catchUp();
         } catch (e) {
           console.error("JUCE event listener error:", e);
           setConnectionStatus('disconnected');
@@ -106,6 +165,8 @@ function App() {
       <h1>Live Audio Classification</h1>
       <div className={`connection-status ${connectionStatus}`}>
         Status: {connectionStatus.toUpperCase()}
+        {analysisStatus === 'warmingUp' && ' (ANALYSIS WARMING UP)'}
+        {analysisStatus === 'unavailable' && ' (ANALYSIS UNAVAILABLE)'}
       </div>
   
       {/* Combined Graph Controls Section */}
@@ -167,6 +228,9 @@ function App() {
           </div>
         )}
       </div>
+
+      {/* Performance Diagnostics */}
+      <DiagnosticsPanel />
     </div>
   );
 }
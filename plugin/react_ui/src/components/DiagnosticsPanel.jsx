@@ -0,0 +1,139 @@
+import { useEffect, useState } from 'react';
+import * as Juce from "../juce/index.js";
+import '../styles/components/diagnostics-panel.css';
+
+const POLL_INTERVAL_MS = 1000;
+const getDiagnostics = Juce.getNativeFunction("getDiagnostics");
+const saveTrace = Juce.getNativeFunction("saveTrace");
+
+// Above these the row is highlighted: the track is close to overloading the machine
+const CPU_LOAD_WARNING = 0.7;
+
+const LATENCY_ROWS = [
+  { key: 'inference', label: 'Inference (submit to result)' },
+  { key: 'modelRun', label: 'Model run per window (all instances)' },
+  { key: 'resampling', label: 'Resampling per call' }
+];
+
+const formatMs = (value) => (value >= 100 ? value.toFixed(0) : value.toFixed(2));
+const formatPercent = (proportion) => `${(proportion * 100).toFixed(1)}%`;
+
+const LatencyTable = ({ latency }) => (
+  <table className="diagnostics-table">
+    <thead>
+      <tr>
+        <th>Stage</th>
+        <th>Count</th>
+        <th>Mean</th>
+        <th>p50</th>
+        <th>p90</th>
+        <th>p99</th>
+        <th>p99.9</th>
+        <th>Max (ms)</th>
+      </tr>
+    </thead>
+    <tbody>
+      {LATENCY_ROWS.map(({ key, label }) => {
+        const snapshot = latency[key];
+        return (
+          <tr key={key}>
+            <td>{label}</td>
+            <td>{snapshot.count}</td>
+            {['meanMs', 'p50Ms', 'p90Ms', 'p99Ms', 'p999Ms', 'maxMs'].map(field => (
+              <td key={field}>{snapshot.count > 0 ? formatMs(snapshot[field]) : '-'}</td>
+            ))}
+          </tr>
+        );
+      })}
+    </tbody>
+  </table>
+);
+
+export const DiagnosticsPanel = () => {
+  const [isOpen, setIsOpen] = useState(false);
+  const [diagnostics, setDiagnostics] = useState(null);
+  const [traceMessage, setTraceMessage] = useState('');
+
+  // Only poll while the panel is open; the plugin does nothing for it otherwise
+  useEffect(() => {
+    if (!isOpen) return;
+
+    let isMounted = true;
+
+    const poll = async () => {
+      try {
+        const latest = await getDiagnostics();
+        if (isMounted) setDiagnostics(latest);
+      } catch (error) {
+        console.error("Diagnostics fetch error:", error);
+      }
+    };
+
+    poll();
+    const interval = setInterval(poll, POLL_INTERVAL_MS);
+
+    return () => {
+      isMounted = false;
+      clearInterval(interval);
+    };
+  }, [isOpen]);
+
+  const handleSaveTrace = async () => {
+    const path = await saveTrace();
+    setTraceMessage(path ? `Trace saved to ${path}` : 'Could not save the trace');
+  };
+
+  const windows = diagnostics?.windows;
+
+  return (
+    <div className="diagnostics-panel">
+      <button className="diagnostics-toggle" onClick={() => setIsOpen(!isOpen)}>
+        {isOpen ? 'Hide Diagnostics' : 'Show Diagnostics'}
+      </button>
+
+      {isOpen && diagnostics && (
+        <div className="diagnostics-content">
+          <div className="diagnostics-summary">
+            <div className={diagnostics.cpu.load > CPU_LOAD_WARNING ? 'warning' : ''}>
+              CPU load: <span className="value">{formatPercent(diagnostics.cpu.load)}</span>
+            </div>
+            <div className={diagnostics.cpu.overruns > 0 ? 'warning' : ''}>
+              Overruns: <span className="value">{diagnostics.cpu.overruns}</span>
+            </div>
+            <div>
+              Mode: <span className="value">{diagnostics.mode}</span> at {diagnostics.detectionRateHz.toFixed(2)} Hz
+            </div>
+          </div>
+
+          <LatencyTable latency={diagnostics.latency} />
+
+          <div className="diagnostics-summary">
+            <div>Submitted: <span className="value">{windows.submitted}</span></div>
+            <div className={windows.late > 0 ? 'warning' : ''}>
+              Late: <span className="value">{windows.late}</span>
+            </div>
+            <div className={windows.dropped > 0 || windows.droppedSamples > 0 ? 'warning' : ''}>
+              Skipped: <span className="value">{windows.dropped}</span> ({windows.droppedSamples} samples)
+            </div>
+            <div>
+              Throttled: <span className="value">{windows.throttled}</span> (~{windows.estimatedSavedMs.toFixed(0)} ms saved)
+            </div>
+            <div>
+              Silence: <span className="value">{windows.gated}</span> ({windows.silenceChecksAgreed}/{windows.silenceChecksRun} checks agreed{windows.silenceGateReopened && ', gate reopened'})
+            </div>
+            <div>
+              Reused: <span className="value">{windows.reused}</span> ({formatPercent(windows.reuseRate)})
+            </div>
+          </div>
+
+          {diagnostics.tracingEnabled && (
+            <div className="diagnostics-trace">
+              <button onClick={handleSaveTrace}>Save Trace</button>
+              {traceMessage && <span>{traceMessage}</span>}
+            </div>
+          )}
+        </div>
+      )}
+    </div>
+  );
+};
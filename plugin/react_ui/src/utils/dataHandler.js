@@ -1,23 +1,56 @@
-import { ClassificationIndices } from "../constants/constants.js";
+import { GroupLabels } from "../constants/constants.js";
+
+// ==== Score Packet Decoding ==== //
+// Layout matches plugin/include/AQUA/ScorePacket.h; everything is little-endian.
+const SCORE_PACKET_HEADER_SIZE = 16;
+const ANALYSIS_STATES = ["warmingUp", "running", "unavailable"];
+
+// Rows (oldest first) from the columns of a yamnetOut.bin packet. Each column is
+// viewed in place over the fetched buffer; only the per-row group arrays are built.
+export const parseScorePacket = (buffer) => {
+  const header = new DataView(buffer, 0, SCORE_PACKET_HEADER_SIZE);
+  const numGroups = header.getUint32(4, true);
+  const count = header.getUint32(8, true);
+
+  let offset = SCORE_PACKET_HEADER_SIZE;
+  const nextColumn = (ArrayType) => {
+    const column = new ArrayType(buffer, offset, count);
+    offset += count * ArrayType.BYTES_PER_ELEMENT;
+    return column;
+  };
+
+  const sequences = nextColumn(BigUint64Array);
+  const audioPositions = nextColumn(BigUint64Array);
+  const times = nextColumn(BigInt64Array);
+  const groups = Array.from({ length: numGroups }, () => nextColumn(Float32Array));
+
+  return {
+    status: ANALYSIS_STATES[header.getUint32(0, true)] ?? "unavailable",
+    results: Array.from({ length: count }, (_, row) => ({
+      sequence: Number(sequences[row]),
+      audioPosition: Number(audioPositions[row]),
+      time: Number(times[row]),
+      groups: groups.map(column => column[row])
+    }))
+  };
+};
 
 // ==== Classification Data Handling ==== //
-export const convertScoresToClassifications = (scores, threshold) => {
-  if (!scores || scores.length === 0) {
-    console.error("Invalid or empty scores array.");
+export const convertScoresToClassifications = (groupScores, threshold, timestamp = Date.now()) => {
+  if (!groupScores || groupScores.length !== GroupLabels.length) {
+    console.error("Invalid group scores array.");
     return [];
   }
 
-  const now = Date.now();
-
   // Helper function to check if a score exceeds the threshold
   const isAboveThreshold = (score) => score > threshold;
 
-  // Iterate through ClassificationIndices to find classifications above the threshold
-  const classifications = Object.entries(ClassificationIndices).flatMap(([label, indices]) => {
-    const highestScore = Math.max(...indices.map(index => scores[index] || 0));
+  // Each group score is already the highest score among that group's classes
+  const classifications = GroupLabels.flatMap((label, index) => {
+    const score = groupScores[index] || 0;
 
-    if (isAboveThreshold(highestScore)) {
-      return { timestamp: now, label, value: highestScore };
+    if (isAboveThreshold(score)) {
+      return { timestamp, label, value: score };
     }
 
     return [];
@@ -28,31 +61,32 @@ export const convertScoresToClassifications = (scores, threshold) => {
 };
 
 // ==== Confidence Tracking Mode ==== //
-export const convertScoresToConfidence = (scores, previousConfidenceData = [], timeWindow = 60000) => {
-  if (!scores || scores.length === 0) {
-    console.error("Invalid or empty scores array.");
+export const convertScoresToConfidence = (groupScores, timestamp = Date.now()) => {
+  if (!groupScores || groupScores.length !== GroupLabels.length) {
+    console.error("Invalid group scores array.");
     return [];
   }
 
-  const now = Date.now();
-
-  const getHighestScore = (indices) => Math.max(...indices.map(index => scores[index] || 0));
   const clampValue = (value) => Math.max(0, Math.min(1, value));
   const roundValue = (value) => parseFloat(value.toFixed(3)); // Round to 3 decimal places
 
-  const newConfidenceData = Object.entries(ClassificationIndices).map(([label, indices]) => ({
-    timestamp: now,
+  return GroupLabels.map((label, index) => ({
+    timestamp,
     label,
-    value: roundValue(clampValue(getHighestScore(indices)))
+    value: roundValue(clampValue(groupScores[index] || 0))
   }));
+};
 
-  // Combine new data with previous data and filter by timeWindow
-  const updatedConfidenceData = [
-    ...previousConfidenceData.filter(d => d.timestamp > now - timeWindow),
-    ...newConfidenceData
-  ];
+// ==== History ==== //
+// Appends points (oldest first) and drops the ones older than timeWindow before the newest.
+// Both arrays are in time order, so only the expired points at the front are looked at.
+export const appendWithinWindow = (previous, added, timeWindow) => {
+  if (added.length === 0) return previous;
 
-  console.log("Updated Confidence Data:", updatedConfidenceData);
+  const cutoff = added[added.length - 1].timestamp - timeWindow;
+  let firstKept = 0;
+  while (firstKept < previous.length && previous[firstKept].timestamp < cutoff) ++firstKept;
+
+  return previous.slice(firstKept).concat(added);
+};
 
-  return updatedConfidenceData;
-};
\ No newline at end of file
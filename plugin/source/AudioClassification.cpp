@@ -10,150 +10,455 @@
 
 #include "AQUA/AudioClassification.h"
 
+// What a gated window publishes: certain Silence, nothing else
+static const std::array<float, ClassificationResult::numClasses> silenceScores = [] {
+    std::array<float, ClassificationResult::numClasses> scores {};
+    scores[label_groups::silenceClassIndex] = 1.0f;
+    return scores;
+}();
+
+static_assert(LogMelFrontend::numPatchFrames == InferenceService::patchFrames
+                  && LogMelFrontend::numMelBands == InferenceService::patchBands,
+              "The front end must produce the patch the backbone model expects");
+
 AudioClassification::AudioClassification() :
-            env(ORT_LOGGING_LEVEL_WARNING, "ModelEnv"),
-            onnxSession(nullptr) // Temporary initialization with nullptr
+            juce::Thread("AQUA Analysis")
 {
-    // Use this method as the place to do any pre-playback initialisation that you need..
-    testONNXRuntime();
-
-    // Initialize ONNX Runtime environment and session
-    env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "ModelEnv");
-    Ort::SessionOptions session_options;
-    session_options.SetIntraOpNumThreads(1);
-    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-    
-    // Debug: Check if memory_info is initialized
-    if (!memory_info) {
-        std::cerr << "Error: memory_info is not initialized!" << std::endl;
-    } else {
-        std::cout << "memory_info initialized successfully." << std::endl;
-    }
+}
 
-    // Start from the common application data directory
-    juce::File libraryDirectory = juce::File::getSpecialLocation(juce::File::commonApplicationDataDirectory)
-                                    .getChildFile("Salsa/AQUA_v1");
-    modelFile = libraryDirectory.getChildFile("yamnet_model.onnx");
-    model_path = modelFile.getFullPathName().toStdString();
+AudioClassification::~AudioClassification()
+{
+    stopThread(workerStopTimeoutMs);
+    inferenceService->removeClient(*this);
+}
 
-    onnxSession = Ort::Session(env, model_path.c_str(), session_options);
-    std::cout << "ONNX model loaded successfully from " << model_path << std::endl;
+void AudioClassification::prepareToPlay(const double sampleRate, const int samplesPerBlock, const double detectionRateHz)
+{
+    juce::ignoreUnused(samplesPerBlock);
 
-    // Debug: Print input/output node information
-    size_t num_input_nodes = onnxSession.GetInputCount();
-    size_t num_output_nodes = onnxSession.GetOutputCount();
+    // The worker owns everything below, so it must not be running while we resize
+    stopThread(workerStopTimeoutMs);
+    inferenceService->removeClient(*this);
 
-    std::cout << "Model has " << num_input_nodes << " inputs and " << num_output_nodes << " outputs." << std::endl;
+    // Everything downstream of the resampler runs at 16k: the window is 0.96 secs, and the hop
+    // comes from the detection rate
+    fifoSize = static_cast<int>(InferenceService::waveformLength);
+    setDetectionRate(detectionRateHz);
+    hopSize = requestedHopSize.load(std::memory_order_relaxed);
+
+    classifierBuffer.assign(fifoSize, 0.0f);
+    inputFifo.assign(fifoSize, 0.0f);
+
+    pos = 0;
+    count = 0;
+    samplesAppended = 0;
+    melFrontend.reset();
+
+    resamplerIsIdle = false;
+    pendingSilentSamples = 0.0;
+    soundEnd = 0;
+    gatedWindowsSinceCheck = 0;
+    gateReopened.store(false, std::memory_order_relaxed);
+    changeDetector.reset();
+    changeDetector.setHopsPerWindow((fifoSize + hopSize - 1) / hopSize);
+    referenceWindowEnd = 0;
+    lastModelWindowEnd = 0;
+
+    SRC.prepareToPlay(sampleRate, analysisSampleRate);
+    resampledBlock.assign(SRC.getMaxOutputSamples(maxResampleChunkSize), 0.0f);
+
+    // One full window of host-rate headroom lets the worker fall almost a whole window behind
+    // (e.g. while an inference is running) before the audio thread has to drop samples.
+    const auto ingestSize = juce::roundToInt(fifoSize * sampleRate / analysisSampleRate) + 1;
+    ingestBuffer.assign(ingestSize, 0.0f);
+    ingestFifo.setTotalSize(ingestSize);
+    ingestFifo.reset();
+    droppedSamples.store(0, std::memory_order_relaxed);
+    droppedWindows.store(0, std::memory_order_relaxed);
+    windowsSubmitted.store(0, std::memory_order_relaxed);
+    windowsThrottled.store(0, std::memory_order_relaxed);
+    hopsSinceSubmitted = 0;
+    windowsGated.store(0, std::memory_order_relaxed);
+    silenceChecksRun.store(0, std::memory_order_relaxed);
+    silenceChecksAgreed.store(0, std::memory_order_relaxed);
+    windowsReused.store(0, std::memory_order_relaxed);
+    resampleTimes.reset();
+    inferenceLatencies.reset();
+    windowsLate.store(0, std::memory_order_relaxed);
+
+    inferenceService->startLoading();
+    startThread();
 }
 
-AudioClassification::~AudioClassification()
+void AudioClassification::releaseResources()
 {
+    stopThread(workerStopTimeoutMs);
+    inferenceService->removeClient(*this);
+    SRC.releaseResources();
 }
 
-void AudioClassification::prepareToPlay(const double sampleRate, const int samplesPerBlock, const int detectionFrequency)
+void AudioClassification::processBlock(std::span<const float> samples)
 {
-    float classifierBufferSize = 15360.0f; // 0.96 secs at 16k
-    float targetSRC = 16000.0f;
-    float resampleRatio = sampleRate / targetSRC;
-    
-    classifierBuffer.resize(classifierBufferSize);
-    output_0.resize(521); // Resize output_0 to match the expected size
+    AQUA_TRACE_ZONE("AudioClassification::processBlock");
+
+    const auto numSamples = static_cast<int>(samples.size());
+    const auto scope = ingestFifo.write(numSamples);
 
-    fifoSize = static_cast<int>(std::round(classifierBufferSize * resampleRatio));
+    std::copy_n(samples.data(), scope.blockSize1, ingestBuffer.data() + scope.startIndex1);
+    std::copy_n(samples.data() + scope.blockSize1, scope.blockSize2, ingestBuffer.data() + scope.startIndex2);
 
-    // Ensure fifoSize is even by rounding up if it's odd
-    if (fifoSize % 2 != 0)
-        fifoSize += 1;
+    if (const auto numDropped = numSamples - scope.blockSize1 - scope.blockSize2; numDropped > 0)
+        droppedSamples.fetch_add(numDropped, std::memory_order_relaxed);
+}
 
-    hopSize = fifoSize / 2;
+void AudioClassification::run()
+{
+    while (!threadShouldExit())
+    {
+        drainIngestFifo();
+        wait(workerPollIntervalMs);
+    }
+}
 
-    SRC.prepareToPlay(fifoSize, classifierBufferSize);
+void AudioClassification::drainIngestFifo()
+{
+    AQUA_TRACE_ZONE("AudioClassification::drainIngestFifo");
 
-    inputFifo.resize(fifoSize, 0.0f);  // FIFO buffer
-    outputFifo.resize(fifoSize, 0.0f);  // Buffer for processing
+    const auto scope = ingestFifo.read(ingestFifo.getNumReady());
 
-    pos = 0;
-    count = 0;
+    resampleAndAppend({ingestBuffer.data() + scope.startIndex1, static_cast<size_t>(scope.blockSize1)});
+    resampleAndAppend({ingestBuffer.data() + scope.startIndex2, static_cast<size_t>(scope.blockSize2)});
 }
 
-void AudioClassification::processSample(const float sample)
+void AudioClassification::resampleAndAppend(std::span<const float> hostSamples)
 {
-    // Store new sample in circular FIFO
-    inputFifo[pos] = sample;
+    const auto needsLogMel = inferenceService->isReady()
+                          && inferenceService->getInputKind() == InferenceService::InputKind::logMelPatch;
 
-    // Advance position (circular buffer logic)
-    pos = (pos + 1) % fifoSize;
+    // Each host sample is converted to 16k exactly once, as it arrives, and each mel frame is
+    // computed once, as soon as its samples are in
+    while (!hostSamples.empty())
+    {
+        const auto chunk = hostSamples.first(juce::jmin(hostSamples.size(), static_cast<size_t>(maxResampleChunkSize)));
+        hostSamples = hostSamples.subspan(chunk.size());
 
-    // Track number of samples received
-    count++;
+        // A check that heard something in a gated window holds the gate open until the next loud
+        // chunk, so quiet but real material goes on running through the model
+        const auto isBelowThresholds = silenceGate.isSilent(SilenceGate::measure(chunk));
 
-    // When hopSize samples are processed, copy the latest classifierBufferSize samples in correct order
-    if (count == hopSize)
-    {
-        count = 0;
+        if (!isBelowThresholds)
+            gateReopened.store(false, std::memory_order_relaxed);
+
+        const auto isSilence = isBelowThresholds && !gateReopened.load(std::memory_order_relaxed);
 
-        // Extract most recent classifierBufferSize samples, handling circular buffer
-        for (int i = 0; i < fifoSize; ++i)
+        // Quiet chunks skip the resampler: they'd come out as (near enough) zeros anyway, so the
+        // equivalent number of zeros goes into the ring instead. The exception is the audio that
+        // will fill the next silence check's window, which has to be the real thing for the check
+        // to be able to tell the gate it was wrong.
+        const auto feedsSilenceCheck = gatedWindowsSinceCheck >= silenceCheckInterval - (fifoSize + hopSize - 1) / hopSize;
+        int numResampled = 0;
+
+        if (isSilence && !feedsSilenceCheck)
         {
-            int fifoIndex = (pos + i) % fifoSize;
-            outputFifo[i] = inputFifo[fifoIndex];
+            pendingSilentSamples += static_cast<double>(chunk.size()) * SRC.getRatio();
+            numResampled = static_cast<int>(pendingSilentSamples);
+            pendingSilentSamples -= numResampled;
+
+            std::fill_n(resampledBlock.data(), numResampled, 0.0f);
+            resamplerIsIdle = true;
+        }
+        else
+        {
+            // The skipped input was silent, so an empty filter history is the right one to resume from
+            if (std::exchange(resamplerIsIdle, false))
+                SRC.reset();
+
+            AQUA_TRACE_ZONE("SampleRateConversion::interpolateAudio");
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            numResampled = SRC.interpolateAudio(chunk, resampledBlock);
+            resampleTimes.record(startTicks, juce::Time::getHighResolutionTicks());
         }
 
-        // Process the frame
-        std::span<float> classifierBufferSpan(classifierBuffer.data(), classifierBuffer.size());
-        std::span<float> outputFifoSpan(outputFifo.data(), outputFifo.size());
-        SRC.interpolateAudio(outputFifoSpan, classifierBufferSpan);
+        if (needsLogMel)
+            melFrontend.pushSamples({resampledBlock.data(), static_cast<size_t>(numResampled)});
+
+        appendToWindow(resampledBlock.data(), numResampled, isSilence);
+    }
+}
+
+void AudioClassification::appendToWindow(const float* samples, int numSamples, bool isSilence)
+{
+    while (numSamples > 0)
+    {
+        // Never copy past the next hop boundary, so each window is analysed as soon as it's complete
+        const auto numToCopy = juce::jmin(numSamples, hopSize - count);
+
+        // Store new samples in the circular FIFO, wrapping at most once
+        const auto numBeforeWrap = juce::jmin(numToCopy, fifoSize - pos);
+        std::copy_n(samples, numBeforeWrap, inputFifo.data() + pos);
+        std::copy_n(samples + numBeforeWrap, numToCopy - numBeforeWrap, inputFifo.data());
+
+        pos = (pos + numToCopy) % fifoSize;
+        count += numToCopy;
+        samplesAppended += static_cast<uint64_t>(numToCopy);
+        if (!isSilence)
+            soundEnd = samplesAppended;
+        changeDetector.pushSamples({samples, static_cast<size_t>(numToCopy)});
+        samples += numToCopy;
+        numSamples -= numToCopy;
+
+        if (count == hopSize)
+        {
+            count = 0;
+            changeDetector.endHop();
+            analyseWindow();
+
+            // Detection rate changes take effect from the next hop
+            if (const auto newHopSize = requestedHopSize.load(std::memory_order_relaxed); newHopSize != hopSize)
+            {
+                hopSize = newHopSize;
+                changeDetector.setHopsPerWindow((fifoSize + hopSize - 1) / hopSize);
+            }
+        }
+    }
+}
+
+bool AudioClassification::shouldAnalyseHop()
+{
+    const auto mode = numConsumers.load(std::memory_order_relaxed) > 0 ? InferenceMode::full
+                                                                          : idleMode.load(std::memory_order_relaxed);
+
+    if (currentMode.exchange(mode, std::memory_order_relaxed) != mode)
+    {
+        static constexpr const char* modeNames[] = { "full", "low duty", "off" };
+        RealtimeLog::info("Inference mode: %s.", modeNames[static_cast<int>(mode)]);
+        hopsSinceSubmitted = 0; // Run the first hop in a new mode straight away
+    }
+
+    // Windows skipped while warming up aren't throttling; they'd be skipped anyway
+    if (mode == InferenceMode::full || !inferenceService->isReady())
+        return true;
+
+    if (mode == InferenceMode::lowDuty && hopsSinceSubmitted++ % getLowDutyInterval() == 0)
+        return true;
+
+    windowsThrottled.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void AudioClassification::analyseWindow()
+{
+    AQUA_TRACE_ZONE("AudioClassification::analyseWindow");
+
+    const auto windowIsSilent = samplesAppended - soundEnd >= static_cast<uint64_t>(fifoSize);
+
+    // Tag the window with where it ends, so its result can be placed on the audio timeline
+    auto tag = samplesAppended;
+
+    if (!windowIsSilent)
+        gatedWindowsSinceCheck = 0; // Checks come every silenceCheckInterval consecutive gated windows
+
+    if (windowIsSilent && inferenceService->isReady())
+    {
+        changeDetector.clearReference();
+        publishResult(silenceScores, samplesAppended);
+        windowsGated.fetch_add(1, std::memory_order_relaxed);
+
+        // Every so often, run the model on a gated window anyway to confirm it agrees
+        if (++gatedWindowsSinceCheck < silenceCheckInterval)
+            return;
+
+        gatedWindowsSinceCheck = 0;
+        tag |= silenceCheckTag;
+    }
+    else if (tryReusePreviousResult() || !shouldAnalyseHop())
+    {
+        return;
+    }
+
+    bool submitted = false;
+
+    if (inferenceService->isReady() && inferenceService->getInputKind() == InferenceService::InputKind::logMelPatch)
+    {
+        // The patch only lines up with a real window once 96 frames have been computed
+        if (melFrontend.hasFullPatch())
+        {
+            melFrontend.copyPatch(classifierBuffer);
+            submitted = processClassification({classifierBuffer.data(), static_cast<size_t>(LogMelFrontend::patchSize)}, tag);
+        }
+    }
+    else
+    {
+        // Linearise the most recent fifoSize samples, oldest first: [pos, end) followed by [0, pos)
+        std::copy(inputFifo.begin() + pos, inputFifo.end(), classifierBuffer.begin());
+        std::copy(inputFifo.begin(), inputFifo.begin() + pos, classifierBuffer.begin() + (fifoSize - pos));
 
         // Perform classification
-        processClassification(classifierBufferSpan);
+        submitted = processClassification({classifierBuffer.data(), classifierBuffer.size()}, tag);
+    }
+
+    // Silence checks can't be a reference for reuse: their result is never published
+    if (submitted && (tag & silenceCheckTag) == 0)
+    {
+        changeDetector.setReferenceToLatestWindow();
+
+        const juce::ScopedLock sl(publishLock);
+        referenceWindowEnd = tag;
+    }
+}
+
+bool AudioClassification::tryReusePreviousResult()
+{
+    const auto toleranceDb = reuseToleranceDb.load(std::memory_order_relaxed);
+
+    if (toleranceDb <= 0.0f || changeDetector.getDistanceFromReferenceDb() > toleranceDb)
+        return false;
+
+    const auto maxAgeSamples = static_cast<uint64_t>(maxReuseAgeMs.load(std::memory_order_relaxed) * analysisSampleRate / 1000.0);
+
+    const juce::ScopedLock sl(publishLock);
+
+    // The reference's own result has to be back, and still recent enough to stand in for this window
+    if (lastModelWindowEnd != referenceWindowEnd || samplesAppended - referenceWindowEnd > maxAgeSamples)
+        return false;
+
+    publishResult(lastModelScores, samplesAppended);
+    windowsReused.fetch_add(1, std::memory_order_relaxed);
+    return true;
+
+}
+
+bool AudioClassification::processClassification(std::span<float> waveform, uint64_t tag) {
+    // Windows that arrive while the model is warming up are expected to be skipped
+    if (!inferenceService->isReady())
+        return false;
+
+    if (!inferenceService->submit(*this, waveform, tag))
+    {
+        droppedWindows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    windowsSubmitted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void AudioClassification::inferenceCompleted(std::span<const float> scores, uint64_t tag, juce::int64 submissionTicks) {
+    const auto completedTicks = juce::Time::getHighResolutionTicks();
+    inferenceLatencies.record(submissionTicks, completedTicks);
+
+    if ((tag & silenceCheckTag) != 0)
+    {
+        checkSilenceGate(scores); // Its Silence result has already been published
+        return;
     }
+
+    // The next window was already due before this one's result came back
+    if (juce::Time::highResolutionTicksToSeconds(completedTicks - submissionTicks) * analysisSampleRate > requestedHopSize.load(std::memory_order_relaxed))
+        windowsLate.fetch_add(1, std::memory_order_relaxed);
+
+    const juce::ScopedLock sl(publishLock);
+    std::copy(scores.begin(), scores.end(), lastModelScores.begin());
+    lastModelWindowEnd = tag;
+    publishResult(scores, tag);
 }
-void AudioClassification::processClassification(std::span<float> waveform) {
-    // Model input/output names
-    const char* inputName[] = {"waveform"};
-    const char* outputNames[] = {"output_0", "output_1", "output_2"};
 
-    // Vector shapes
-    std::vector<int64_t> waveform_shape = {15360};
-    std::vector<int64_t> output_0_shape = {1, 521};
-    std::vector<int64_t> output_1_shape = {1, 1024};
-    std::vector<int64_t> output_2_shape = {96, 64};
+void AudioClassification::publishResult(std::span<const float> scores, uint64_t windowEnd) {
+    const juce::ScopedLock sl(publishLock);
 
-    // Create input tensors
-    std::vector<Ort::Value> input_tensors;
-    input_tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, waveform.data(), waveform.size(), waveform_shape.data(), 1));
+    auto& result = results.getWriteBuffer();
+    result.audioPosition = windowEnd;
+    std::copy(scores.begin(), scores.end(), result.scores.begin());
+    label_groups::reduce(scores, result.groupScores);
 
-    // Output placeholders
-    std::vector<float> output_1(1 * 1024);  // Size based on expected output
-    std::vector<float> output_2(96 * 64);  // Size based on expected output
+    result.sequence = nextSequence++;
+    result.timeMs = juce::Time::currentTimeMillis();
+    history.push(result.sequence, result.audioPosition, result.timeMs, result.groupScores);
+    results.publish();
+    sendChangeMessage();
 
-    std::vector<Ort::Value> output_tensors;
-    output_tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, output_0.data(), output_0.size(), output_0_shape.data(), 2));
-    output_tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, output_1.data(), output_1.size(), output_1_shape.data(), 2));
-    output_tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, output_2.data(), output_2.size(), output_2_shape.data(), 2));
+    if (result.sequence == 1)
+    {
+        timeToFirstScoreMs.store(juce::Time::getMillisecondCounterHiRes() - creationTimeMs, std::memory_order_relaxed);
+        RealtimeLog::info("First classification result after %.1f ms.", timeToFirstScoreMs.load(std::memory_order_relaxed));
+    }
+}
 
-    // Perform inference
-    onnxSession.Run(Ort::RunOptions{nullptr}, inputName, input_tensors.data(), input_tensors.size(), outputNames, output_tensors.data(), output_tensors.size());
+void AudioClassification::checkSilenceGate(std::span<const float> scores) {
+    std::array<float, label_groups::numGroups> groupScores;
+    label_groups::reduce(scores, groupScores);
 
-    // // Release the lock after updating output_0
-    // outputLock.clear(std::memory_order_release);
+    const auto topGroup = std::distance(groupScores.begin(), std::max_element(groupScores.begin(), groupScores.end()));
+
+    silenceChecksRun.fetch_add(1, std::memory_order_relaxed);
+
+    if (topGroup == label_groups::silenceGroup)
+    {
+        silenceChecksAgreed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    gateReopened.store(true, std::memory_order_relaxed);
+    RealtimeLog::info("Silence gate check: the model heard %s in a gated window; reopening the gate.",
+                      label_groups::groups[static_cast<size_t>(topGroup)].name);
 }
 
-std::vector<float> AudioClassification::getOutputScores() const {
-    // Wait until the lock is available
-    // while (outputLock.test_and_set(std::memory_order_acquire)) {
-    //     // Spin until the lock is released
-    // }
+AudioClassification::ReuseStats AudioClassification::getReuseStats() const noexcept {
+    const auto reused = windowsReused.load(std::memory_order_relaxed);
+    const auto total = reused + windowsSubmitted.load(std::memory_order_relaxed);
 
-    // Return the output_0 data
-    //auto span = std::span<float>(output_0); // Directly construct span from std::vector
+    return { reused, total > 0 ? static_cast<float>(reused) / static_cast<float>(total) : 0.0f };
+}
 
-    return output_0;
+AudioClassification::LatencyStats AudioClassification::getLatencyStats() const noexcept {
+    return { inferenceLatencies.getSnapshot(),
+             resampleTimes.getSnapshot(),
+             inferenceService->getRunTimeSnapshot(),
+             windowsLate.load(std::memory_order_relaxed) };
 }
 
-// =====  Function to test ONNX Runtime initialization ======
+AudioClassification::SilenceStats AudioClassification::getSilenceStats() const noexcept {
+    return { windowsGated.load(std::memory_order_relaxed),
+             silenceChecksRun.load(std::memory_order_relaxed),
+             silenceChecksAgreed.load(std::memory_order_relaxed),
+             gateReopened.load(std::memory_order_relaxed) };
+}
+
+void AudioClassification::setDetectionRate(double rateHz) noexcept {
+    const auto rate = juce::jlimit(minDetectionRateHz, maxDetectionRateHz, rateHz);
+    requestedHopSize.store(juce::jlimit(1, static_cast<int>(InferenceService::waveformLength), juce::roundToInt(analysisSampleRate / rate)),
+                           std::memory_order_relaxed);
+}
+
+double AudioClassification::getDetectionRate() const noexcept {
+    return analysisSampleRate / requestedHopSize.load(std::memory_order_relaxed);
+}
+
+AnalysisState AudioClassification::getAnalysisState() const noexcept {
+    switch (inferenceService->getState())
+    {
+        case InferenceService::State::ready:   return AnalysisState::running;
+        case InferenceService::State::failed:  return AnalysisState::unavailable;
+        case InferenceService::State::loading: break;
+    }
+
+    return AnalysisState::warmingUp;
+}
+
+InferenceMode AudioClassification::getInferenceMode() const noexcept {
+    return currentMode.load(std::memory_order_relaxed);
+}
+
+AudioClassification::ThrottleStats AudioClassification::getThrottleStats() const noexcept {
+    const auto throttled = windowsThrottled.load(std::memory_order_relaxed);
+
+    return { getInferenceMode(),
+             windowsSubmitted.load(std::memory_order_relaxed),
+             throttled,
+             throttled * inferenceService->getMeanWindowRunTimeMs() };
+}
 
-void AudioClassification::testONNXRuntime() {
-    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "Test");
-    std::cout << "ONNX Runtime initialized successfully!" << std::endl;
+const ClassificationResult& AudioClassification::getLatestResult() {
+    results.update();
+    return results.getReadBuffer();
 }
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    ClassificationHistory.cpp
+    Created: 19 Oct 2026 2:05:48pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/ClassificationHistory.h"
+
+void ClassificationHistory::push(uint64_t sequence, uint64_t audioPosition, juce::int64 timeMs,
+                                 std::span<const float, label_groups::numGroups> scores)
+{
+    const auto slot = static_cast<size_t>(sequence % capacity);
+
+    const juce::ScopedLock sl(lock);
+    jassert(sequence > latestSequence);
+
+    sequences[slot] = sequence;
+    audioPositions[slot] = audioPosition;
+    timesMs[slot] = timeMs;
+
+    for (size_t g = 0; g < label_groups::numGroups; ++g)
+        groupScores[g][slot] = scores[g];
+
+    latestSequence = sequence;
+}
+
+ClassificationHistory::Columns ClassificationHistory::getSince(uint64_t sinceSequence) const
+{
+    Columns columns;
+
+    const juce::ScopedLock sl(lock);
+
+    // Slots that haven't been written since the ring was created still hold sequence 0, so check
+    // each one rather than assuming the whole range is filled
+    const auto oldestHeld = latestSequence >= capacity ? latestSequence - capacity + 1 : 1;
+    const auto first = juce::jmax(sinceSequence + 1, oldestHeld);
+
+    if (first > latestSequence)
+        return columns;
+
+    const auto maxEntries = static_cast<size_t>(latestSequence - first + 1);
+    columns.sequences.reserve(maxEntries);
+    columns.audioPositions.reserve(maxEntries);
+    columns.timesMs.reserve(maxEntries);
+    for (auto& column : columns.groupScores)
+        column.reserve(maxEntries);
+
+    for (auto sequence = first; sequence <= latestSequence; ++sequence)
+    {
+        const auto slot = static_cast<size_t>(sequence % capacity);
+
+        if (sequences[slot] != sequence)
+            continue;
+
+        columns.sequences.push_back(sequence);
+        columns.audioPositions.push_back(audioPositions[slot]);
+        columns.timesMs.push_back(timesMs[slot]);
+
+        for (size_t g = 0; g < label_groups::numGroups; ++g)
+            columns.groupScores[g].push_back(groupScores[g][slot]);
+    }
+
+    return columns;
+}
+
+uint64_t ClassificationHistory::getLatestSequence() const
+{
+    const juce::ScopedLock sl(lock);
+    return latestSequence;
+}
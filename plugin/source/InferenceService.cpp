@@ -0,0 +1,443 @@
+/*
+  ==============================================================================
+
+    InferenceService.cpp
+    Created: 18 Oct 2026 11:20:45am
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/InferenceService.h"
+
+#include <algorithm>
+
+InferenceService::InferenceService() : juce::Thread("AQUA Inference")
+{
+}
+
+InferenceService::~InferenceService()
+{
+    stopThread(schedulerStopTimeoutMs);
+}
+
+int InferenceService::getNumGlobalThreads()
+{
+    // Leave the rest of the machine to the host's own audio and UI threads
+    return juce::jmax(1, juce::SystemStats::getNumPhysicalCpus() / 2);
+}
+
+juce::File& InferenceService::getModelDirectoryOverride()
+{
+    static juce::File directory;
+    return directory;
+}
+
+void InferenceService::setModelDirectory(const juce::File& newDirectory)
+{
+    getModelDirectoryOverride() = newDirectory;
+}
+
+juce::File InferenceService::getModelDirectory()
+{
+    if (getModelDirectoryOverride() != juce::File())
+        return getModelDirectoryOverride();
+
+    return juce::File::getSpecialLocation(juce::File::commonApplicationDataDirectory).getChildFile("Salsa/AQUA_v1");
+}
+
+juce::File& InferenceService::getModelCacheDirectoryOverride()
+{
+    static juce::File directory;
+    return directory;
+}
+
+void InferenceService::setModelCacheDirectory(const juce::File& newDirectory)
+{
+    getModelCacheDirectoryOverride() = newDirectory;
+}
+
+juce::File InferenceService::getModelCacheDirectory()
+{
+    if (getModelCacheDirectoryOverride() != juce::File())
+        return getModelCacheDirectoryOverride();
+
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("Salsa/AQUA_v1/ModelCache");
+}
+
+void InferenceService::startLoading()
+{
+    const juce::ScopedLock sl(startLock);
+
+    // The model is loaded at the start of the scheduler thread, see run()
+    if (!isThreadRunning() && getState() == State::loading)
+        startThread();
+}
+
+void InferenceService::loadModel()
+{
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    try
+    {
+        // One Env with global thread pools; sessions opt out of their own pools below
+        Ort::ThreadingOptions threading_options;
+        threading_options.SetGlobalIntraOpNumThreads(getNumGlobalThreads());
+        threading_options.SetGlobalInterOpNumThreads(1);
+        threading_options.SetGlobalSpinControl(0); // Don't let idle pool threads spin next to the audio thread
+        threading_options.SetGlobalDenormalAsZero();
+
+        env = Ort::Env(threading_options, ORT_LOGGING_LEVEL_WARNING, "ModelEnv");
+
+        const auto libraryDirectory = getModelDirectory();
+        const auto backboneFile = libraryDirectory.getChildFile("yamnet_backbone.onnx");
+        inputKind = backboneFile.existsAsFile() ? InputKind::logMelPatch : InputKind::waveform;
+        modelFile = inputKind == InputKind::logMelPatch ? backboneFile : libraryDirectory.getChildFile("yamnet_model.onnx");
+        model_path = modelFile.getFullPathName().toStdString();
+
+        createSession();
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        inputName = session.GetInputNameAllocated(0, allocator).get();
+        outputName = session.GetOutputNameAllocated(0, allocator).get(); // output_0, the 521 class scores
+
+        // Debug: Print input/output node information
+        RealtimeLog::info("Model has %d inputs and %d outputs.", static_cast<int>(session.GetInputCount()), static_cast<int>(session.GetOutputCount()));
+
+        // Only a model exported with a dynamic leading batch dimension can take several windows per Run
+        const auto inputShape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        const auto unbatchedRank = inputKind == InputKind::waveform ? 1u : 2u;
+        batchedInput = inputShape.size() == unbatchedRank + 1 && inputShape[0] < 0;
+        RealtimeLog::info("Model takes %s as input.", inputKind == InputKind::waveform ? "a waveform" : "a log-mel patch");
+        RealtimeLog::info("Model %s batched inference.", batchedInput ? "supports" : "does not support");
+
+        for (auto& batch : batches)
+            prepareBindings(batch);
+
+        modelLoadTimeMs.store(juce::Time::getMillisecondCounterHiRes() - startMs, std::memory_order_relaxed);
+        RealtimeLog::info("Model ready after %.1f ms (%s).", modelLoadTimeMs.load(std::memory_order_relaxed),
+                          loadedFromCache ? "warm, from optimised model cache" : "cold");
+
+        state.store(State::ready, std::memory_order_release);
+    }
+    catch (const Ort::Exception& e)
+    {
+        RealtimeLog::error("Error loading ONNX model from %s: %s", model_path.c_str(), e.what());
+        session = Ort::Session(nullptr);
+        state.store(State::failed, std::memory_order_release);
+    }
+}
+
+void InferenceService::createSession()
+{
+    const auto cacheFile = getOptimisedModelCacheFile();
+    const auto cache_path = cacheFile.getFullPathName().toStdString();
+
+    // Warm start: the cached graph has already been through the optimiser
+    if (cacheFile.existsAsFile())
+    {
+        try
+        {
+            Ort::SessionOptions cached_options;
+            cached_options.DisablePerSessionThreads();
+            cached_options.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+
+            session = Ort::Session(env, cache_path.c_str(), cached_options);
+            loadedFromCache = true;
+            cacheFile.setLastModificationTime(juce::Time::getCurrentTime()); // Marks it as recently used
+            RealtimeLog::info("ONNX model loaded from optimised model cache %s", cache_path.c_str());
+            return;
+        }
+        catch (const Ort::Exception& e)
+        {
+            RealtimeLog::error("Discarding unreadable optimised model cache %s: %s", cache_path.c_str(), e.what());
+            cacheFile.deleteFile();
+        }
+    }
+
+    // Cold start: optimise the source model and save the result for next time
+    const auto cacheDirectory = cacheFile.getParentDirectory();
+    cacheDirectory.createDirectory();
+
+    juce::TemporaryFile temporaryCacheFile(cacheFile);
+    const auto temporary_path = temporaryCacheFile.getFile().getFullPathName().toStdString();
+
+    Ort::SessionOptions session_options;
+    session_options.DisablePerSessionThreads();
+    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT");
+    session_options.SetOptimizedModelFilePath(temporary_path.c_str());
+
+    session = Ort::Session(env, model_path.c_str(), session_options);
+    loadedFromCache = false;
+    RealtimeLog::info("ONNX model loaded successfully from %s", model_path.c_str());
+
+    // Another instance may be writing the same entry; whichever finishes last wins
+    if (!temporaryCacheFile.overwriteTargetFileWithTemporary())
+        RealtimeLog::error("Could not write optimised model cache %s", cache_path.c_str());
+
+    evictLeastRecentlyUsedCacheFiles(cacheDirectory);
+}
+
+void InferenceService::evictLeastRecentlyUsedCacheFiles(const juce::File& cacheDirectory)
+{
+    // Entries for other models, ORT builds or CPUs may still be in use by another plugin build
+    // sharing this folder, so nothing is removed just for not matching this one's key
+    auto entries = cacheDirectory.findChildFiles(juce::File::findFiles, false, "yamnet_*.ort");
+
+    if (entries.size() <= maxCachedModels)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const juce::File& a, const juce::File& b)
+              { return a.getLastModificationTime() > b.getLastModificationTime(); });
+
+    for (int i = maxCachedModels; i < entries.size(); ++i)
+    {
+        RealtimeLog::info("Evicting least recently used optimised model cache %s", entries.getReference(i).getFileName().toRawUTF8());
+        entries.getReference(i).deleteFile();
+    }
+}
+
+juce::File InferenceService::getOptimisedModelCacheFile() const
+{
+    // The optimised graph is only valid for the exact source model, ORT build and instruction set
+    juce::String key;
+    key << "model=" << juce::String::toHexString(static_cast<juce::int64>(hashFileContents(modelFile)))
+        << ";ort=" << juce::String(Ort::GetVersionString())
+        << ";cpu=" << getCpuFeatureString();
+
+    return getModelCacheDirectory().getChildFile("yamnet_" + juce::String::toHexString(static_cast<juce::int64>(key.hashCode64())) + ".ort");
+}
+
+juce::String InferenceService::getCpuFeatureString()
+{
+    juce::String features;
+
+   #if JUCE_ARM
+    features << "arm";
+   #else
+    features << "x86";
+   #endif
+
+    if (juce::SystemStats::hasSSE41())    features << "+sse4.1";
+    if (juce::SystemStats::hasAVX())      features << "+avx";
+    if (juce::SystemStats::hasAVX2())     features << "+avx2";
+    if (juce::SystemStats::hasFMA3())     features << "+fma3";
+    if (juce::SystemStats::hasAVX512F())  features << "+avx512f";
+    if (juce::SystemStats::hasNeon())     features << "+neon";
+
+    return features;
+}
+
+uint64_t InferenceService::hashFileContents(const juce::File& file)
+{
+    // FNV-1a over the memory-mapped model; fast enough that a warm start doesn't notice it
+    juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+
+    const auto* data = static_cast<const uint8_t*>(mappedFile.getData());
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < mappedFile.getSize(); ++i)
+        hash = (hash ^ data[i]) * 1099511628211ull;
+
+    return hash;
+}
+
+//===============================================================================================
+bool InferenceService::submit(Client& client, std::span<const float> input, uint64_t tag)
+{
+    if (!isReady())
+        return false;
+
+    const auto inputLength = getInputLength();
+    jassert(input.size() == static_cast<size_t>(inputLength));
+
+    bool shouldWakeScheduler = false;
+
+    {
+        const juce::ScopedLock sl(gatherLock);
+
+        if (gathering->size == maxBatchSize)
+            return false;
+
+        const auto index = gathering->size++;
+        std::copy(input.begin(), input.end(), gathering->inputs.begin() + index * inputLength);
+        gathering->clients[index] = &client;
+        gathering->tags[index] = tag;
+        gathering->submissionTicks[index] = juce::Time::getHighResolutionTicks();
+
+        if (index == 0)
+            gathering->firstSubmissionMs = juce::Time::getMillisecondCounterHiRes();
+
+        shouldWakeScheduler = index == 0 || gathering->size == maxBatchSize;
+    }
+
+    if (shouldWakeScheduler)
+        notify();
+
+    return true;
+}
+
+void InferenceService::removeClient(Client& client)
+{
+    {
+        const juce::ScopedLock sl(gatherLock);
+
+        for (auto& c : gathering->clients)
+            if (c == &client)
+                c = nullptr;
+    }
+
+    // Waits for a delivery that is already underway, then makes sure the batch that is
+    // currently running can't deliver to this client either.
+    const juce::ScopedLock sl(deliveryLock);
+    const juce::ScopedLock gl(gatherLock);
+
+    for (auto& c : running->clients)
+        if (c == &client)
+            c = nullptr;
+}
+
+//===============================================================================================
+void InferenceService::run()
+{
+    loadModel();
+
+    while (!threadShouldExit())
+    {
+        double firstSubmissionMs = 0.0;
+        bool isFull = false;
+        bool isEmpty = true;
+
+        {
+            const juce::ScopedLock sl(gatherLock);
+            firstSubmissionMs = gathering->firstSubmissionMs;
+            isFull = gathering->size == maxBatchSize;
+            isEmpty = gathering->size == 0;
+        }
+
+        if (isEmpty)
+        {
+            wait(-1);
+            continue;
+        }
+
+        // Give other instances until the budget runs out to add their windows to this batch
+        const auto remainingMs = firstSubmissionMs + latencyBudgetMs.load() - juce::Time::getMillisecondCounterHiRes();
+
+        if (!isFull && remainingMs > 1.0)
+        {
+            wait(static_cast<int>(remainingMs));
+            continue;
+        }
+
+        {
+            const juce::ScopedLock sl(gatherLock);
+            std::swap(gathering, running);
+        }
+
+        runBatch(*running);
+    }
+}
+
+void InferenceService::prepareBindings(Batch& batch)
+{
+    // output_1 (embeddings) and output_2 (log-mel patch) are never fetched
+    const auto inputLength = getInputLength();
+
+    auto bind = [&](float* inputs, float* scores, const int64_t numWindows, const bool withBatchDimension)
+    {
+        std::vector<int64_t> input_shape;
+
+        if (withBatchDimension)
+            input_shape.push_back(numWindows);
+
+        if (inputKind == InputKind::waveform)
+            input_shape.push_back(waveformLength);
+        else
+            input_shape.insert(input_shape.end(), {patchFrames, patchBands});
+
+        const std::array<int64_t, 2> output_0_shape = {numWindows, numClasses};
+
+        auto& input = batch.tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, inputs, static_cast<size_t>(numWindows * inputLength),
+                                                                                 input_shape.data(), input_shape.size()));
+        auto& output = batch.tensors.emplace_back(Ort::Value::CreateTensor<float>(memory_info, scores, static_cast<size_t>(numWindows * numClasses),
+                                                                                  output_0_shape.data(), output_0_shape.size()));
+
+        auto& binding = batch.bindings.emplace_back(session);
+        binding.BindInput(inputName.c_str(), input);
+        binding.BindOutput(outputName.c_str(), output);
+    };
+
+    batch.tensors.clear();
+    batch.bindings.clear();
+    batch.tensors.reserve(2 * maxBatchSize);
+    batch.bindings.reserve(maxBatchSize);
+
+    // bindings[i] covers the first i + 1 windows as one batched tensor when the model takes a
+    // batch dimension; otherwise it covers window i on its own.
+    for (int i = 0; i < maxBatchSize; ++i)
+    {
+        if (batchedInput)
+            bind(batch.inputs.data(), batch.scores.data(), i + 1, true);
+        else
+            bind(batch.inputs.data() + i * inputLength, batch.scores.data() + i * numClasses, 1, false);
+    }
+}
+
+void InferenceService::runBatch(Batch& batch)
+{
+    AQUA_TRACE_ZONE("InferenceService::runBatch");
+
+    bool succeeded = true;
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (batchedInput)
+    {
+        succeeded = runBinding(batch.bindings[static_cast<size_t>(batch.size - 1)]);
+    }
+    else
+    {
+        for (int i = 0; i < batch.size; ++i)
+            succeeded &= runBinding(batch.bindings[static_cast<size_t>(i)]);
+    }
+
+    // Only this thread writes it, so a load-modify-store is enough
+    const auto msPerWindow = (juce::Time::getMillisecondCounterHiRes() - startMs) / batch.size;
+    const auto previousMean = meanWindowRunTimeMs.load(std::memory_order_relaxed);
+    meanWindowRunTimeMs.store(previousMean == 0.0 ? msPerWindow : previousMean + 0.1 * (msPerWindow - previousMean),
+                              std::memory_order_relaxed);
+    runTimes.recordMicroseconds(static_cast<uint32_t>(juce::jmin(msPerWindow * 1000.0, static_cast<double>(LatencyHistogram::maxTrackableUs))));
+
+    {
+        const juce::ScopedLock sl(deliveryLock);
+
+        for (int i = 0; i < batch.size; ++i)
+        {
+            if (succeeded && batch.clients[i] != nullptr)
+                batch.clients[i]->inferenceCompleted({batch.scores.data() + i * numClasses, static_cast<size_t>(numClasses)},
+                                                   batch.tags[i], batch.submissionTicks[i]);
+
+            batch.clients[i] = nullptr;
+        }
+
+        batch.size = 0;
+    }
+}
+
+bool InferenceService::runBinding(Ort::IoBinding& binding)
+{
+    // Inputs and outputs are preallocated and already bound, so a steady-state Run makes no
+    // heap allocations of its own; ONNX Runtime's intermediates come from its arena.
+    try
+    {
+        AQUA_TRACE_ZONE("Ort::Session::Run");
+        session.Run(runOptions, binding);
+        return true;
+    }
+    catch (const Ort::Exception& e)
+    {
+        RealtimeLog::error("Error during inference: %s", e.what());
+        return false;
+    }
+}
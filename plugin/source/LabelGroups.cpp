@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    LabelGroups.cpp
+    Created: 19 Oct 2026 9:12:37am
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/LabelGroups.h"
+
+#include <JuceHeader.h>
+#include <algorithm>
+
+namespace label_groups
+{
+// Catch a table edit that leaves the groups out of step with classIndices
+static constexpr bool groupsCoverIndices()
+{
+    int next = 0;
+    for (const auto& group : groups)
+    {
+        if (group.firstIndex != next || group.numIndices <= 0)
+            return false;
+        next += group.numIndices;
+    }
+    return next == static_cast<int>(classIndices.size());
+}
+
+static_assert(groupsCoverIndices(), "Label groups must tile classIndices in order");
+static_assert(classIndices[groups[silenceGroup].firstIndex] == silenceClassIndex);
+
+// One past the highest class index any group reads
+static constexpr size_t numScoresRequired = static_cast<size_t>(*std::max_element(classIndices.begin(), classIndices.end())) + 1;
+static_assert(numScoresRequired <= 521, "Label groups must only use YAMNet's 521 classes");
+
+void reduce(std::span<const float> scores, std::span<float, numGroups> groupScores) noexcept
+{
+    jassert(scores.size() >= numScoresRequired);
+
+    for (size_t g = 0; g < numGroups; ++g)
+    {
+        const auto& group = groups[g];
+        const auto* index = classIndices.data() + group.firstIndex;
+
+        float highest = scores[static_cast<size_t>(index[0])];
+        for (int i = 1; i < group.numIndices; ++i)
+            highest = std::max(highest, scores[static_cast<size_t>(index[i])]);
+
+        groupScores[g] = highest;
+    }
+}
+}  // namespace label_groups
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    LatencyHistogram.cpp
+    Created: 21 Oct 2026 11:03:27am
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/LatencyHistogram.h"
+
+#include <cmath>
+
+void LatencyHistogram::record(juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    const auto us = juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e6;
+    recordMicroseconds(static_cast<uint32_t>(juce::jlimit(0.0, static_cast<double>(maxTrackableUs), std::round(us))));
+}
+
+void LatencyHistogram::recordMicroseconds(uint32_t valueUs) noexcept
+{
+    valueUs = juce::jmin(valueUs, maxTrackableUs);
+
+    buckets[static_cast<size_t>(getBucketIndex(valueUs))].fetch_add(1, std::memory_order_relaxed);
+    totalUs.fetch_add(valueUs, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    auto previousMax = maxUs.load(std::memory_order_relaxed);
+    while (valueUs > previousMax && !maxUs.compare_exchange_weak(previousMax, valueUs, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    totalUs.store(0, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+}
+
+// [0, 32) one bucket per microsecond; then [32 << shift, 64 << shift) in 32 steps of 1 << shift
+int LatencyHistogram::getBucketIndex(uint32_t valueUs) noexcept
+{
+    if (valueUs < subBucketCount)
+        return static_cast<int>(valueUs);
+
+    const auto shift = juce::findHighestSetBit(valueUs) - subBucketBits;
+    return (shift + 1) * static_cast<int>(subBucketCount) + static_cast<int>((valueUs >> shift) - subBucketCount);
+}
+
+uint32_t LatencyHistogram::getBucketUpperEdge(int index) noexcept
+{
+    if (index < static_cast<int>(subBucketCount))
+        return static_cast<uint32_t>(index);
+
+    const auto shift = index / static_cast<int>(subBucketCount) - 1;
+    const auto subBucket = static_cast<uint32_t>(index % static_cast<int>(subBucketCount)) + subBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::getSnapshot() const noexcept
+{
+    std::array<uint32_t, numBuckets> counts;
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+        total += counts[i] = buckets[i].load(std::memory_order_relaxed);
+
+    if (total == 0)
+        return {};
+
+    const auto maxValueUs = maxUs.load(std::memory_order_relaxed);
+
+    const auto percentileMs = [&](double proportion)
+    {
+        const auto rank = juce::jmax(uint64_t { 1 }, static_cast<uint64_t>(std::ceil(proportion * static_cast<double>(total))));
+        uint64_t seen = 0;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            seen += counts[static_cast<size_t>(i)];
+
+            if (seen >= rank)
+                return juce::jmin(getBucketUpperEdge(i), maxValueUs) / 1000.0;
+        }
+
+        return maxValueUs / 1000.0;
+    };
+
+    Snapshot snapshot;
+    snapshot.count = total;
+    snapshot.meanMs = static_cast<double>(totalUs.load(std::memory_order_relaxed)) / static_cast<double>(juce::jmax(uint64_t { 1 }, count.load(std::memory_order_relaxed))) / 1000.0;
+    snapshot.p50Ms = percentileMs(0.5);
+    snapshot.p90Ms = percentileMs(0.9);
+    snapshot.p99Ms = percentileMs(0.99);
+    snapshot.p999Ms = percentileMs(0.999);
+    snapshot.maxMs = maxValueUs / 1000.0;
+    return snapshot;
+}
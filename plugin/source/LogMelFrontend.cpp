@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    LogMelFrontend.cpp
+    Created: 18 Oct 2026 4:05:52pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/LogMelFrontend.h"
+
+#include <cmath>
+
+LogMelFrontend::LogMelFrontend()
+{
+    // tf.signal.hann_window(periodic=True), as used by YAMNet's STFT
+    window.resize(frameLength);
+    for (int i = 0; i < frameLength; ++i)
+        window[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / frameLength);
+
+    // Same triangles as tf.signal.linear_to_mel_weight_matrix: edges evenly spaced on the HTK mel
+    // scale, slopes measured in mel, and the DC bin left out
+    constexpr int numSpectrumBins = fftSize / 2 + 1;
+    const auto melMin = hertzToMel(melMinHz);
+    const auto melMax = hertzToMel(melMaxHz);
+    const auto melStep = (melMax - melMin) / (numMelBands + 1);
+
+    melBands.resize(numMelBands);
+
+    for (int band = 0; band < numMelBands; ++band)
+    {
+        const auto lowerEdge = melMin + band * melStep;
+        const auto centre = lowerEdge + melStep;
+        const auto upperEdge = centre + melStep;
+
+        auto& melBand = melBands[static_cast<size_t>(band)];
+        melBand.firstBin = -1;
+
+        for (int bin = 1; bin < numSpectrumBins; ++bin)
+        {
+            const auto mel = hertzToMel(bin * sampleRate / fftSize);
+            const auto weight = juce::jmax(0.0, juce::jmin((mel - lowerEdge) / (centre - lowerEdge), (upperEdge - mel) / (upperEdge - centre)));
+
+            if (weight <= 0.0)
+            {
+                if (melBand.firstBin >= 0)
+                    break;
+
+                continue;
+            }
+
+            if (melBand.firstBin < 0)
+                melBand.firstBin = bin;
+
+            melBand.weights.push_back(static_cast<float>(weight));
+        }
+
+        if (melBand.firstBin < 0)
+            melBand.firstBin = 0;
+    }
+
+    fftBuffer.resize(2 * fftSize);
+    sampleRing.resize(frameLength);
+    patchRing.resize(patchSize);
+
+    reset();
+}
+
+double LogMelFrontend::hertzToMel(const double frequency)
+{
+    return 1127.0 * std::log(1.0 + frequency / 700.0);
+}
+
+void LogMelFrontend::reset()
+{
+    std::fill(sampleRing.begin(), sampleRing.end(), 0.0f);
+    std::fill(patchRing.begin(), patchRing.end(), std::log(logOffset));
+    sampleWritePos = 0;
+    samplesUntilNextFrame = frameLength;
+    patchWriteFrame = 0;
+    numFramesSinceReset = 0;
+}
+
+void LogMelFrontend::pushSamples(std::span<const float> samples)
+{
+    while (!samples.empty())
+    {
+        // Copy up to the next frame boundary, wrapping the ring at most once
+        const auto numToCopy = juce::jmin(static_cast<int>(samples.size()), samplesUntilNextFrame);
+        const auto numBeforeWrap = juce::jmin(numToCopy, frameLength - sampleWritePos);
+
+        std::copy_n(samples.data(), numBeforeWrap, sampleRing.data() + sampleWritePos);
+        std::copy_n(samples.data() + numBeforeWrap, numToCopy - numBeforeWrap, sampleRing.data());
+
+        sampleWritePos = (sampleWritePos + numToCopy) % frameLength;
+        samplesUntilNextFrame -= numToCopy;
+        samples = samples.subspan(static_cast<size_t>(numToCopy));
+
+        if (samplesUntilNextFrame == 0)
+        {
+            computeFrame();
+            samplesUntilNextFrame = frameHop;
+        }
+    }
+}
+
+void LogMelFrontend::computeFrame()
+{
+    // Oldest sample first, windowed, zero-padded to fftSize
+    const auto numToEnd = frameLength - sampleWritePos;
+    juce::FloatVectorOperations::multiply(fftBuffer.data(), sampleRing.data() + sampleWritePos, window.data(), numToEnd);
+    juce::FloatVectorOperations::multiply(fftBuffer.data() + numToEnd, sampleRing.data(), window.data() + numToEnd, sampleWritePos);
+    juce::FloatVectorOperations::clear(fftBuffer.data() + frameLength, 2 * fftSize - frameLength);
+
+    // Leaves |X[k]| in the first fftSize / 2 + 1 entries
+    fft.performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+    auto* frame = patchRing.data() + patchWriteFrame * numMelBands;
+
+    for (int band = 0; band < numMelBands; ++band)
+    {
+        const auto& melBand = melBands[static_cast<size_t>(band)];
+        const auto* magnitudes = fftBuffer.data() + melBand.firstBin;
+
+        float energy = 0.0f;
+        for (size_t i = 0; i < melBand.weights.size(); ++i)
+            energy += magnitudes[i] * melBand.weights[i];
+
+        frame[band] = std::log(energy + logOffset);
+    }
+
+    patchWriteFrame = (patchWriteFrame + 1) % numPatchFrames;
+    ++numFramesSinceReset;
+}
+
+void LogMelFrontend::copyPatch(std::span<float> destination) const
+{
+    jassert(destination.size() >= static_cast<size_t>(patchSize));
+
+    // [patchWriteFrame, end) holds the oldest frames, [0, patchWriteFrame) the newest
+    const auto oldestOffset = static_cast<size_t>(patchWriteFrame * numMelBands);
+    std::copy(patchRing.begin() + static_cast<std::ptrdiff_t>(oldestOffset), patchRing.end(), destination.begin());
+    std::copy(patchRing.begin(), patchRing.begin() + static_cast<std::ptrdiff_t>(oldestOffset),
+              destination.begin() + static_cast<std::ptrdiff_t>(patchSize - oldestOffset));
+}
@@ -8,43 +8,47 @@
 #include "juce_graphics/juce_graphics.h"
 #include "juce_gui_extra/juce_gui_extra.h"
 #include "AQUA/ParameterIDs.hpp"
-#include <WebViewFiles.h>
+#include "AQUA/RealtimeLog.h"
+#include "AQUA/ScorePacket.h"
+#include "AQUA/Trace.h"
+#include "AQUA/WebAssetCache.h"
 
 namespace webview_plugin {
 namespace {
-std::vector<std::byte> streamToVector(juce::InputStream& stream) {
-  using namespace juce;
-  const auto sizeInBytes = static_cast<size_t>(stream.getTotalLength());
-  std::vector<std::byte> result(sizeInBytes);
-  stream.setPosition(0);
-  [[maybe_unused]] const auto bytesRead =
-      stream.read(result.data(), result.size());
-  jassert(bytesRead == static_cast<ssize_t>(sizeInBytes));
-  return result;
-}
-
-static const char* getMimeForExtension(const juce::String& extension) {
-  static const std::unordered_map<juce::String, const char*> mimeMap = {
-      {{"htm"}, "text/html"},
-      {{"html"}, "text/html"},
-      {{"txt"}, "text/plain"},
-      {{"jpg"}, "image/jpeg"},
-      {{"jpeg"}, "image/jpeg"},
-      {{"svg"}, "image/svg+xml"},
-      {{"ico"}, "image/vnd.microsoft.icon"},
-      {{"json"}, "application/json"},
-      {{"png"}, "image/png"},
-      {{"css"}, "text/css"},
-      {{"map"}, "application/json"},
-      {{"js"}, "text/javascript"},
-      {{"woff2"}, "font/woff2"}};
-
-  if (const auto it = mimeMap.find(extension.toLowerCase());
-      it != mimeMap.end())
-    return it->second;
-
-  jassertfalse;
-  return "";
+const char* getAnalysisStateName(AnalysisState analysisState) {
+  switch (analysisState) {
+    case AnalysisState::running:
+      return "running";
+    case AnalysisState::unavailable:
+      return "unavailable";
+    case AnalysisState::warmingUp:
+      break;
+  }
+  return "warmingUp";
+}
+
+const char* getInferenceModeName(InferenceMode mode) {
+  switch (mode) {
+    case InferenceMode::lowDuty:
+      return "lowDuty";
+    case InferenceMode::off:
+      return "off";
+    case InferenceMode::full:
+      break;
+  }
+  return "full";
+}
+
+juce::var toVar(const LatencyHistogram::Snapshot& snapshot) {
+  juce::DynamicObject::Ptr object{new juce::DynamicObject{}};
+  object->setProperty("count", static_cast<juce::int64>(snapshot.count));
+  object->setProperty("meanMs", snapshot.meanMs);
+  object->setProperty("p50Ms", snapshot.p50Ms);
+  object->setProperty("p90Ms", snapshot.p90Ms);
+  object->setProperty("p99Ms", snapshot.p99Ms);
+  object->setProperty("p999Ms", snapshot.p999Ms);
+  object->setProperty("maxMs", snapshot.maxMs);
+  return object.get();
 }
 
 juce::Identifier getExampleEventId() {
@@ -53,27 +57,6 @@ juce::Identifier getExampleEventId() {
   return id;
 }
 
-std::vector<std::byte> getWebViewFileAsBytes(const juce::String& filepath) {
-  juce::MemoryInputStream zipStream{webview_files::webview_files_zip,
-                                    webview_files::webview_files_zipSize,
-                                    false};
-  juce::ZipFile zipFile{zipStream};
-
-  // We have to enumerate zip entries instead of retrieving them by name
-  // because their names may have prefixes
-  for (const auto i : std::views::iota(0, zipFile.getNumEntries())) {
-    const auto* zipEntry = zipFile.getEntry(i);
-
-    if (zipEntry->filename.endsWith(filepath)) {
-      const std::unique_ptr<juce::InputStream> entryStream{
-          zipFile.createStreamForEntry(*zipEntry)};
-      return streamToVector(*entryStream);
-    }
-  }
-
-  return {};
-}
-
 constexpr auto LOCAL_DEV_SERVER_ADDRESS = "http://127.0.0.1:8080";
 }  // namespace
 
@@ -110,6 +93,16 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
                              completion) {
                     nativeFunction(args, std::move(completion));
                   })
+              .withNativeFunction(
+                  juce::Identifier{"getDiagnostics"},
+                  [this](const juce::Array<juce::var>&,
+                         juce::WebBrowserComponent::NativeFunctionCompletion
+                             completion) { completion(getDiagnostics()); })
+              .withNativeFunction(
+                  juce::Identifier{"saveTrace"},
+                  [this](const juce::Array<juce::var>&,
+                         juce::WebBrowserComponent::NativeFunctionCompletion
+                             completion) { completion(saveTrace()); })
                 }
   {
   addAndMakeVisible(webView);
@@ -126,59 +119,189 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
   setResizable(true, true);
   setSize(800, 600);
 
-  startTimer(60);
+  processorRef.getAudioClassification().addChangeListener(this);
+  startTimer(statePollIntervalMs);
 }
 
-AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {}
+AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {
+  processorRef.getAudioClassification().removeChangeListener(this);
+
+  if (isConsumingResults)
+    processorRef.getAudioClassification().removeConsumer();
+}
 
 void AudioPluginAudioProcessorEditor::resized() {
   auto bounds = getBounds();
   webView.setBounds(getLocalBounds().reduced(10));
 }
 
+void AudioPluginAudioProcessorEditor::visibilityChanged() {
+  updateConsumerRegistration();
+}
+
+void AudioPluginAudioProcessorEditor::updateConsumerRegistration() {
+  if (isShowing() == isConsumingResults)
+    return;
+
+  isConsumingResults = !isConsumingResults;
+
+  if (isConsumingResults)
+    processorRef.getAudioClassification().addConsumer();
+  else
+    processorRef.getAudioClassification().removeConsumer();
+}
+
 void AudioPluginAudioProcessorEditor::timerCallback() {
-  webView.emitEventIfBrowserIsVisible("yamnetOut", juce::var{});
+  AQUA_TRACE_ZONE("Editor::timerCallback");
+
+  updateConsumerRegistration();
+
+  if (processorRef.getAudioClassification().getAnalysisState() !=
+      lastEmittedState)
+    emitLatestResult();
+}
+
+void AudioPluginAudioProcessorEditor::changeListenerCallback(
+    juce::ChangeBroadcaster*) {
+  AQUA_TRACE_ZONE("Editor::emitLatestResult");
+
+  emitLatestResult();
+}
+
+void AudioPluginAudioProcessorEditor::emitLatestResult() {
+  auto& classifier = processorRef.getAudioClassification();
+  const auto& result = classifier.getLatestResult();
+  const auto state = classifier.getAnalysisState();
+
+  if (result.sequence == lastEmittedSequence && state == lastEmittedState)
+    return;
+
+  lastEmittedSequence = result.sequence;
+  lastEmittedState = state;
+
+  // Small enough to ride along with the event, so the UI only fetches
+  // yamnetOut.bin when it opens or finds it has missed a result
+  juce::Array<juce::var> groups;
+  groups.ensureStorageAllocated(static_cast<int>(result.groupScores.size()));
+  for (const auto score : result.groupScores)
+    groups.add(score);
+
+  juce::DynamicObject::Ptr payload{new juce::DynamicObject{}};
+  payload->setProperty("sequence", static_cast<juce::int64>(result.sequence));
+  payload->setProperty("audioPosition",
+                       static_cast<juce::int64>(result.audioPosition));
+  payload->setProperty("time", result.timeMs);
+  payload->setProperty("status", getAnalysisStateName(state));
+  payload->setProperty("groups", groups);
+
+  webView.emitEventIfBrowserIsVisible("yamnetOut", payload.get());
 }
 
 auto AudioPluginAudioProcessorEditor::getResource(const juce::String& url) const
     -> std::optional<Resource> {
   //std::cout << "ResourceProvider called with " << url << std::endl;
+  AQUA_TRACE_ZONE("Editor::getResource");
 
   const auto resourceToRetrieve =
       url == "/" ? "index.html" : url.fromFirstOccurrenceOf("/", false, false);
 
-  if (resourceToRetrieve == "yamnetOut.json") {
-    juce::DynamicObject::Ptr levelData{new juce::DynamicObject{}};
-
-    // Use the getter to retrieve output_0
-    std::vector<float> outputScores = processorRef.getAudioClassification().getOutputScores();
+  // yamnetOut.bin/<N>: every held result after sequence N. The sequence goes
+  // in the path because not every WebView backend passes the query through.
+  if (resourceToRetrieve.upToFirstOccurrenceOf("/", false, false) ==
+      "yamnetOut.bin") {
+    const auto since =
+        resourceToRetrieve.fromFirstOccurrenceOf("/", false, false)
+            .getLargeIntValue();
+    return Resource{getHistorySince(static_cast<uint64_t>(
+                        juce::jmax(juce::int64{0}, since))),
+                    juce::String{"application/octet-stream"}};
+  }
 
-    // Convert outputScores (std::span<float>) to juce::Array<juce::var>
-    juce::Array<juce::var> scoresArray;
-    for (const auto& score : outputScores) {
-        scoresArray.add(score);
+  if (const auto asset =
+          WebAssetCache::getInstance().find(resourceToRetrieve.toStdString())) {
+    if (resourceToRetrieve == "index.html" && !hasLoggedOpenTime) {
+      hasLoggedOpenTime = true;
+      RealtimeLog::info("Editor served index.html %.1f ms after opening.",
+                        juce::Time::getMillisecondCounterHiRes() - openStartMs);
     }
 
-    // Add the scoresArray to levelData
-    levelData->setProperty("scores", scoresArray);
-
-    const auto jsonString = juce::JSON::toString(levelData.get());
-    juce::MemoryInputStream stream{jsonString.getCharPointer(),
-                                   jsonString.getNumBytesAsUTF8(), false};
-    return juce::WebBrowserComponent::Resource{
-        streamToVector(stream), juce::String{"application/json"}};
-  }
-
-  const auto resource = getWebViewFileAsBytes(resourceToRetrieve);
-  if (!resource.empty()) {
-    const auto extension =
-        resourceToRetrieve.fromLastOccurrenceOf(".", false, false);
-    return Resource{std::move(resource), getMimeForExtension(extension)};
+    // Resource owns its bytes, so this is the one copy; nothing is inflated
+    return Resource{asset->bytes, juce::String{asset->mimeType}};
   }
 
   return std::nullopt;
 }
 
+std::vector<std::byte> AudioPluginAudioProcessorEditor::getHistorySince(
+    uint64_t sinceSequence) const {
+  auto& classifier = processorRef.getAudioClassification();
+
+  // Straight from the history's ring into the response body (see
+  // ScorePacket.h for the layout)
+  return score_packet::write(classifier.getHistory(), sinceSequence,
+                             classifier.getAnalysisState());
+}
+
+juce::var AudioPluginAudioProcessorEditor::getDiagnostics() const {
+  auto& classifier = processorRef.getAudioClassification();
+  const auto throttle = classifier.getThrottleStats();
+  const auto silence = classifier.getSilenceStats();
+  const auto reuse = classifier.getReuseStats();
+  const auto latency = classifier.getLatencyStats();
+
+  juce::DynamicObject::Ptr cpu{new juce::DynamicObject{}};
+  cpu->setProperty("load", processorRef.getCpuLoad());
+  cpu->setProperty("overruns", processorRef.getNumOverruns());
+
+  // Everything counted since the last prepareToPlay
+  juce::DynamicObject::Ptr windows{new juce::DynamicObject{}};
+  windows->setProperty("submitted", throttle.windowsSubmitted);
+  windows->setProperty("late", latency.windowsLate);
+  windows->setProperty("dropped", classifier.getNumDroppedWindows());
+  windows->setProperty("droppedSamples", classifier.getNumDroppedSamples());
+  windows->setProperty("throttled", throttle.windowsThrottled);
+  windows->setProperty("estimatedSavedMs", throttle.estimatedSavedMs);
+  windows->setProperty("gated", silence.windowsGated);
+  windows->setProperty("silenceChecksRun", silence.checksRun);
+  windows->setProperty("silenceChecksAgreed", silence.checksAgreed);
+  windows->setProperty("silenceGateReopened", silence.reopened);
+  windows->setProperty("reused", reuse.windowsReused);
+  windows->setProperty("reuseRate", reuse.reuseRate);
+
+  juce::DynamicObject::Ptr latencies{new juce::DynamicObject{}};
+  latencies->setProperty("inference", toVar(latency.inference));
+  latencies->setProperty("modelRun", toVar(latency.modelRun));
+  latencies->setProperty("resampling", toVar(latency.resampling));
+
+  juce::DynamicObject::Ptr diagnostics{new juce::DynamicObject{}};
+  diagnostics->setProperty(
+      "status", getAnalysisStateName(classifier.getAnalysisState()));
+  diagnostics->setProperty(
+      "mode", getInferenceModeName(classifier.getInferenceMode()));
+  diagnostics->setProperty("detectionRateHz", classifier.getDetectionRate());
+  diagnostics->setProperty("tracingEnabled", trace::isEnabled);
+  diagnostics->setProperty("cpu", cpu.get());
+  diagnostics->setProperty("windows", windows.get());
+  diagnostics->setProperty("latency", latencies.get());
+  return diagnostics.get();
+}
+
+juce::String AudioPluginAudioProcessorEditor::saveTrace() const {
+  const auto file =
+      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+          .getChildFile("Salsa/AQUA_v1/Traces")
+          .getChildFile("AQUA-" +
+                        juce::Time::getCurrentTime().formatted(
+                            "%Y-%m-%d_%H-%M-%S") +
+                        ".json");
+
+  if (!file.getParentDirectory().createDirectory() ||
+      !trace::writeChromeTrace(file))
+    return {};
+
+  return file.getFullPathName();
+}
+
 void AudioPluginAudioProcessorEditor::nativeFunction(
     const juce::Array<juce::var>& args,
     juce::WebBrowserComponent::NativeFunctionCompletion completion) {
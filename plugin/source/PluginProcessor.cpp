@@ -1,7 +1,10 @@
 #include "AQUA/PluginProcessor.h"
 #include <juce_audio_processors/juce_audio_processors.h>
+#if !AQUA_HEADLESS
 #include "AQUA/PluginEditor.h"
+#endif
 #include "AQUA/ParameterIDs.hpp"
+#include "AQUA/Trace.h"
 #include <cmath>
 #include <functional>
 #include <juce_dsp/juce_dsp.h>
@@ -18,12 +21,19 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
 #endif
               ),
       state{*this, nullptr, "PARAMETERS", createParameterLayout(parameters)} {
+  instantiationTimeMs =
+      juce::Time::getMillisecondCounterHiRes() - constructionStartMs;
+  RealtimeLog::info("AQUA instantiated in %.1f ms.", instantiationTimeMs);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
 
 const juce::String AudioPluginAudioProcessor::getName() const {
+#if AQUA_HEADLESS
+  return "AQUA";
+#else
   return JucePlugin_Name;
+#endif
 }
 
 bool AudioPluginAudioProcessor::acceptsMidi() const {
@@ -82,12 +92,15 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate,
                                               int samplesPerBlock) {
   using namespace juce;
 
-  audioClassifier.prepareToPlay(sampleRate, samplesPerBlock, 16000.0f);
+  loadMeasurer.reset(sampleRate, samplesPerBlock);
+  audioClassifier.prepareToPlay(sampleRate, samplesPerBlock,
+                                parameters.detectionRate->get());
 }
 
 void AudioPluginAudioProcessor::releaseResources() {
   // When playback stops, you can use this as an opportunity to free up any
   // spare memory, etc.
+  audioClassifier.releaseResources();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported(
@@ -118,6 +131,11 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                              juce::MidiBuffer& midiMessages) {
   juce::ignoreUnused(midiMessages);
 
+  AQUA_TRACE_THREAD_NAME("Host audio");
+  AQUA_TRACE_ZONE("Processor::processBlock");
+  const juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer{
+      loadMeasurer, buffer.getNumSamples()};
+
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -125,12 +143,14 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  auto* channelData = buffer.getWritePointer(0); // Use the first channel
+  // Only an atomic store; the analysis worker applies it at its next hop
+  audioClassifier.setDetectionRate(parameters.detectionRate->get());
 
-  for (int i = 0; i < buffer.getNumSamples(); ++i)
-  {
-      audioClassifier.processSample(channelData[i]);
-  }
+  // Use the first channel
+  audioClassifier.processBlock(
+      {buffer.getReadPointer(0), static_cast<size_t>(buffer.getNumSamples())});
+
+  AQUA_TRACE_ZONE("Processor::distortion");
 
   juce::dsp::AudioBlock<float> block{buffer};
   if (parameters.distortionType->getIndex() == 1) {
@@ -154,11 +174,19 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 }
 
 bool AudioPluginAudioProcessor::hasEditor() const {
+#if AQUA_HEADLESS
+  return false;  // Built without the WebView, e.g. for the host simulator
+#else
   return true;  // (change this to false if you choose to not supply an editor)
+#endif
 }
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor() {
+#if AQUA_HEADLESS
+  return nullptr;
+#else
   return new AudioPluginAudioProcessorEditor(*this);
+#endif
 }
 
 void AudioPluginAudioProcessor::getStateInformation(
@@ -206,6 +234,20 @@ AudioPluginAudioProcessor::createParameterLayout(
     layout.add(std::move(parameter));
   }
 
+  {
+    // Results per second: one per 0.96 sec window up to 8
+    auto parameter = std::make_unique<AudioParameterFloat>(
+        id::DETECTION_RATE, "detection rate",
+        NormalisableRange<float>{
+            static_cast<float>(AudioClassification::minDetectionRateHz),
+            static_cast<float>(AudioClassification::maxDetectionRateHz), 0.f,
+            0.5f},
+        static_cast<float>(AudioClassification::defaultDetectionRateHz),
+        AudioParameterFloatAttributes{}.withLabel("Hz"));
+    parameters.detectionRate = parameter.get();
+    layout.add(std::move(parameter));
+  }
+
   return layout;
 }
 }  // namespace webview_plugin
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    PolyphaseResampler.cpp
+    Created: 18 Oct 2026 2:41:09pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/PolyphaseResampler.h"
+
+#include <cmath>
+#include <numeric>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <immintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+bool getIntegerRates(const double inputSampleRate, const double outputSampleRate, long& inputRate, long& outputRate)
+{
+    inputRate = std::lround(inputSampleRate);
+    outputRate = std::lround(outputSampleRate);
+
+    return inputRate > 0 && outputRate > 0
+        && std::abs(inputSampleRate - static_cast<double>(inputRate)) < 1.0e-6
+        && std::abs(outputSampleRate - static_cast<double>(outputRate)) < 1.0e-6;
+}
+}
+
+bool PolyphaseResampler::supportsRates(const double inputSampleRate, const double outputSampleRate)
+{
+    long inputRate = 0, outputRate = 0;
+
+    if (!getIntegerRates(inputSampleRate, outputSampleRate, inputRate, outputRate) || outputRate > inputRate)
+        return false;
+
+    return outputRate / std::gcd(inputRate, outputRate) <= maxUpFactor;
+}
+
+void PolyphaseResampler::prepare(const double inputSampleRate, const double outputSampleRate)
+{
+    jassert(supportsRates(inputSampleRate, outputSampleRate));
+
+    long inputRate = 0, outputRate = 0;
+    getIntegerRates(inputSampleRate, outputSampleRate, inputRate, outputRate);
+
+    const auto divisor = std::gcd(inputRate, outputRate);
+    upFactor = static_cast<int>(outputRate / divisor);
+    downFactor = static_cast<int>(inputRate / divisor);
+
+    // Prototype lowpass at the upsampled rate L * fin, cut off halfway between the passband and
+    // stopband edges of the lower of the two rates
+    const auto prototypeRate = inputSampleRate * upFactor;
+    const auto lowerRate = juce::jmin(inputSampleRate, outputSampleRate);
+    const auto passbandEdge = 0.46875 * lowerRate;
+    const auto stopbandEdge = 0.53125 * lowerRate;
+    const auto cutoff = 0.5 * (passbandEdge + stopbandEdge) / prototypeRate;
+    const auto transitionWidth = juce::MathConstants<double>::twoPi * (stopbandEdge - passbandEdge) / prototypeRate;
+
+    // Kaiser's estimates for the filter length and window shape
+    const auto numTaps = static_cast<int>(std::ceil((stopbandAttenuationDb - 8.0) / (2.285 * transitionWidth))) + 1;
+    const auto beta = 0.1102 * (stopbandAttenuationDb - 8.7);
+
+    tapsPerPhase = ((numTaps + upFactor - 1) / upFactor + 7) & ~7;
+    const auto prototypeLength = tapsPerPhase * upFactor;
+
+    std::vector<double> prototype(static_cast<size_t>(prototypeLength));
+    const auto centre = 0.5 * (numTaps - 1);
+    const auto windowNormalisation = besselI0(beta);
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const auto x = i - centre;
+        const auto sinc = x == 0.0 ? 2.0 * cutoff
+                                   : std::sin(juce::MathConstants<double>::twoPi * cutoff * x) / (juce::MathConstants<double>::pi * x);
+        const auto ratio = x / centre;
+        const auto window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / windowNormalisation;
+
+        prototype[static_cast<size_t>(i)] = sinc * window;
+        sum += prototype[static_cast<size_t>(i)];
+    }
+
+    // Unity gain per phase once the L-fold zero stuffing is accounted for
+    const auto gain = upFactor / sum;
+
+    coefficients.assign(static_cast<size_t>(prototypeLength), 0.0f);
+
+    for (int p = 0; p < upFactor; ++p)
+        for (int k = 0; k < tapsPerPhase; ++k)
+            coefficients[static_cast<size_t>(p * tapsPerPhase + (tapsPerPhase - 1 - k))] =
+                static_cast<float>(prototype[static_cast<size_t>(p + k * upFactor)] * gain);
+
+    history.assign(static_cast<size_t>(tapsPerPhase - 1 + maxBlockSize), 0.0f);
+    reset();
+}
+
+void PolyphaseResampler::reset()
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    numBuffered = tapsPerPhase - 1;
+    inputIndex = tapsPerPhase - 1;
+    phase = 0;
+}
+
+int PolyphaseResampler::getMaxOutputSamples(const int numInputSamples) const
+{
+    return static_cast<int>((static_cast<long>(numInputSamples) * upFactor) / downFactor) + 2;
+}
+
+int PolyphaseResampler::process(std::span<const float> input, std::span<float> output)
+{
+    // Anything less and input would be left over once the output fills up
+    jassert(output.size() >= static_cast<size_t>(getMaxOutputSamples(static_cast<int>(input.size()))));
+
+    int numGenerated = 0;
+
+    while (!input.empty())
+    {
+        if (numGenerated == static_cast<int>(output.size()))
+            break;
+
+        const auto numToAppend = juce::jmin(input.size(), history.size() - static_cast<size_t>(numBuffered));
+        std::copy_n(input.data(), numToAppend, history.data() + numBuffered);
+        numBuffered += static_cast<int>(numToAppend);
+        input = input.subspan(numToAppend);
+
+        while (inputIndex < numBuffered && numGenerated < static_cast<int>(output.size()))
+        {
+            output[static_cast<size_t>(numGenerated++)] = dotProduct(history.data() + inputIndex - (tapsPerPhase - 1),
+                                                                     coefficients.data() + phase * tapsPerPhase,
+                                                                     tapsPerPhase);
+            phase += downFactor;
+            inputIndex += phase / upFactor;
+            phase %= upFactor;
+        }
+
+        // Keep just the history the next output needs
+        const auto numToDiscard = juce::jmin(inputIndex - (tapsPerPhase - 1), numBuffered);
+        std::copy(history.begin() + numToDiscard, history.begin() + numBuffered, history.begin());
+        numBuffered -= numToDiscard;
+        inputIndex -= numToDiscard;
+    }
+
+    return numGenerated;
+}
+
+float PolyphaseResampler::dotProduct(const float* a, const float* b, const int numSamples) noexcept
+{
+    // numSamples is always a multiple of 8
+    jassert(numSamples % 8 == 0);
+
+   #if JUCE_USE_SSE_INTRINSICS && defined(__AVX__)
+    auto acc = _mm256_setzero_ps();
+
+    for (int i = 0; i < numSamples; i += 8)
+       #if defined(__FMA__)
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+       #else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+       #endif
+
+    auto sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+   #elif JUCE_USE_SSE_INTRINSICS
+    auto acc0 = _mm_setzero_ps();
+    auto acc1 = _mm_setzero_ps();
+
+    for (int i = 0; i < numSamples; i += 8)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    auto sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+   #elif JUCE_USE_ARM_NEON
+    auto acc0 = vdupq_n_f32(0.0f);
+    auto acc1 = vdupq_n_f32(0.0f);
+
+    for (int i = 0; i < numSamples; i += 8)
+    {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+
+    const auto acc = vaddq_f32(acc0, acc1);
+    const auto pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+   #else
+    float sum = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+        sum += a[i] * b[i];
+
+    return sum;
+   #endif
+}
+
+double PolyphaseResampler::besselI0(const double x)
+{
+    // Power series for the zeroth-order modified Bessel function of the first kind
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 50; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+
+        if (term < sum * 1.0e-12)
+            break;
+    }
+
+    return sum;
+}
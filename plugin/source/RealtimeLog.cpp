@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.cpp
+    Created: 18 Oct 2026 4:12:37pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/RealtimeLog.h"
+
+RealtimeLog::RealtimeLog() noexcept
+{
+    for (uint32_t i = 0; i < capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+RealtimeLog& RealtimeLog::getInstance() noexcept
+{
+    static RealtimeLog instance;
+    return instance;
+}
+
+uint64_t RealtimeLog::getNumDroppedMessages() noexcept
+{
+    return getInstance().numDropped.load(std::memory_order_relaxed);
+}
+
+uint64_t RealtimeLog::getNumSuppressedMessages() noexcept
+{
+    return getInstance().numSuppressed.load(std::memory_order_relaxed);
+}
+
+// Bounded multi-producer queue: each slot's sequence says whose turn it is, so producers only
+// contend on the enqueue position and never wait on one another.
+RealtimeLog::Slot* RealtimeLog::beginWrite() noexcept
+{
+    auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[position % capacity];
+        const auto lag = static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) - position);
+
+        if (lag == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.publishedSequence = position + 1;
+                return &slot;
+            }
+        }
+        else if (lag < 0)
+        {
+            // Full: the message thread hasn't caught up
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void RealtimeLog::endWrite(Slot& slot) noexcept
+{
+    slot.sequence.store(slot.publishedSequence, std::memory_order_release);
+}
+
+void RealtimeLog::flush()
+{
+    getInstance().flushQueue();
+}
+
+void RealtimeLog::flushAll()
+{
+    auto& log = getInstance();
+    log.flushQueue();
+    log.flushRepeats(true);
+}
+
+void RealtimeLog::flushQueue()
+{
+    const juce::ScopedLock sl(flushLock);
+
+    for (;;)
+    {
+        auto& slot = slots[dequeuePosition % capacity];
+
+        if (static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) - (dequeuePosition + 1)) < 0)
+            break;
+
+        const auto level = slot.level;
+        const auto timeMs = static_cast<double>(slot.timeMs);
+        const auto* format = slot.format;
+        const juce::String message(slot.text.data());
+
+        slot.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+        ++dequeuePosition;
+
+        auto& repeat = repeats[format];
+
+        if (timeMs - repeat.intervalStartMs >= repeatIntervalMs)
+        {
+            if (repeat.numHeldBack > 0)
+                writeRepeatCount(repeat);
+
+            repeat = { timeMs, 0, 0, level, {} };
+        }
+
+        if (repeat.numWritten < maxRepeatsPerInterval)
+        {
+            ++repeat.numWritten;
+            write(level, message);
+        }
+        else
+        {
+            ++repeat.numHeldBack;
+            repeat.level = level;
+            repeat.lastHeldBack = message;
+            numSuppressed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // A burst that has stopped never sees its message again, so its count goes out once its
+    // interval is over rather than waiting for the next repeat
+    flushRepeats(false);
+
+    const auto dropped = numDropped.load(std::memory_order_relaxed);
+
+    if (dropped != numDroppedReported)
+    {
+        write(Level::error, "Log queue full; dropped " + juce::String(static_cast<juce::uint64>(dropped - numDroppedReported)) + " messages.");
+        numDroppedReported = dropped;
+    }
+}
+
+void RealtimeLog::flushRepeats(bool includeOpenIntervals)
+{
+    const juce::ScopedLock sl(flushLock);
+    const auto nowMs = static_cast<double>(juce::Time::getMillisecondCounter());
+
+    for (auto it = repeats.begin(); it != repeats.end();)
+    {
+        const auto& repeat = it->second;
+
+        if (!includeOpenIntervals && nowMs - repeat.intervalStartMs < repeatIntervalMs)
+        {
+            ++it;
+            continue;
+        }
+
+        if (repeat.numHeldBack > 0)
+            writeRepeatCount(repeat);
+
+        // Its next message starts a fresh interval, as if it had never been seen
+        it = repeats.erase(it);
+    }
+}
+
+void RealtimeLog::write(Level level, const juce::String& message)
+{
+    juce::Logger::writeToLog((level == Level::error ? "AQUA error: " : "AQUA: ") + message);
+}
+
+void RealtimeLog::writeRepeatCount(const RepeatState& repeat)
+{
+    write(repeat.level, "(\"" + repeat.lastHeldBack + "\" repeated " + juce::String(repeat.numHeldBack) + " more times)");
+}
+
+//==============================================================================
+RealtimeLog::Drainer::Drainer()
+{
+    startTimer(flushIntervalMs);
+}
+
+RealtimeLog::Drainer::~Drainer()
+{
+    stopTimer();
+    flushAll();
+}
+
+void RealtimeLog::Drainer::timerCallback()
+{
+    flush();
+}
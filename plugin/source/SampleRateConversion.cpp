@@ -6,8 +6,10 @@
     Author:  William Wedgwood
  
     notes for usage:
-    When using this, you must first calculate the size of output buffer in the parent function. This will be static int cast of the sample rate / target sample rate.
-    When its passed to this function, we must calculate the exact value needed between the input buffer and output buffer size. This will vary unless the resample ratio is an interger value or divisible by the output buffer size.
+    This is a streaming converter: feed it the host-rate audio as it arrives, in blocks of any
+    size, and it returns however many target-rate samples those blocks produced. The filter
+    state carries over between calls, so consecutive blocks join up seamlessly and no sample is
+    ever converted twice.
 
   ==============================================================================
 */
@@ -15,28 +17,39 @@
 #include "AQUA/SampleRateConversion.h"
 
 SampleRateConversion::SampleRateConversion()
-    : resampleState(nullptr), resampleError(0), resampleRatio(1.0)
+    : resampleState(nullptr), resampleError(0), srcData{}, resampleRatio(1.0)
 {
 }
 
 SampleRateConversion::~SampleRateConversion()
 {
+    releaseResources();
 }
 
-void SampleRateConversion::prepareToPlay(const int inBufferSize, const int outBufferSize)
+void SampleRateConversion::prepareToPlay(const double inputSampleRate, const double outputSampleRate, const Quality quality)
 {
-    if (resampleState) src_delete(resampleState); // Cleanup if already initialized
+    releaseResources(); // Cleanup if already initialized
 
-    resampleState = src_new(SRC_SINC_BEST_QUALITY, 1, &resampleError);
-    if (!resampleState) {
-        std::cerr << "Error initializing upsample SRC_STATE: " << src_strerror(resampleError) << std::endl;
+    resampleRatio = outputSampleRate / inputSampleRate;
+    usePolyphase = quality == Quality::automatic && resampleRatio != 1.0
+                   && PolyphaseResampler::supportsRates(inputSampleRate, outputSampleRate);
+
+    if (usePolyphase) {
+        polyphase.prepare(inputSampleRate, outputSampleRate);
         return;
     }
 
-    resampleRatio = static_cast<double>(outBufferSize) / static_cast<double>(inBufferSize);
+    const auto converterType = quality == Quality::sincFastest ? SRC_SINC_FASTEST
+                             : quality == Quality::sincMedium  ? SRC_SINC_MEDIUM_QUALITY
+                                                               : SRC_SINC_BEST_QUALITY;
+
+    resampleState = src_new(converterType, 1, &resampleError);
+    if (!resampleState) {
+        RealtimeLog::error("Error initializing upsample SRC_STATE: %s", src_strerror(resampleError));
+        return;
+    }
 
-    srcData.input_frames = inBufferSize;
-    srcData.output_frames = outBufferSize;
+    srcData = {};
     srcData.src_ratio = resampleRatio;
     srcData.end_of_input = 0;
 }
@@ -49,19 +62,60 @@ void SampleRateConversion::releaseResources()
     }
 }
 
-void SampleRateConversion::interpolateAudio(const std::span<float> &inputBuffer, std::span<float> &outputBuffer)
+void SampleRateConversion::reset()
 {
-    if (resampleRatio == 1.0f)  // Bypass if no resampling needed
+    if (usePolyphase)
+        polyphase.reset();
+    else if (resampleState)
+        src_reset(resampleState);
+}
+
+int SampleRateConversion::getMaxOutputSamples(const int numInputSamples) const
+{
+    if (usePolyphase)
+        return polyphase.getMaxOutputSamples(numInputSamples);
+
+    // libsamplerate can release a few extra samples it was holding back from the previous call
+    return static_cast<int>(std::ceil(numInputSamples * resampleRatio)) + 16;
+}
+
+int SampleRateConversion::interpolateAudio(std::span<const float> inputBuffer, std::span<float> outputBuffer)
+{
+    if (resampleRatio == 1.0)  // Bypass if no resampling needed
     {
         std::copy(inputBuffer.begin(), inputBuffer.end(), outputBuffer.begin());
-        return;
+        return static_cast<int>(inputBuffer.size());
     }
-    
-    srcData.data_in = inputBuffer.data();
-    srcData.data_out = outputBuffer.data();
-    
-    int processError = src_process(resampleState, &srcData);
-    if (processError) {
-        std::cerr << "Error during resampling: " << src_strerror(processError) << std::endl;
+
+    if (usePolyphase)
+        return polyphase.process(inputBuffer, outputBuffer);
+
+    if (!resampleState)
+        return 0;
+
+    int numGenerated = 0;
+
+    // src_process may stop early when it runs out of output space, so keep going until all of
+    // the input has been consumed
+    while (!inputBuffer.empty() && numGenerated < static_cast<int>(outputBuffer.size()))
+    {
+        srcData.data_in = inputBuffer.data();
+        srcData.input_frames = static_cast<long>(inputBuffer.size());
+        srcData.data_out = outputBuffer.data() + numGenerated;
+        srcData.output_frames = static_cast<long>(outputBuffer.size()) - numGenerated;
+
+        int processError = src_process(resampleState, &srcData);
+        if (processError) {
+            RealtimeLog::error("Error during resampling: %s", src_strerror(processError));
+            break;
+        }
+
+        inputBuffer = inputBuffer.subspan(static_cast<size_t>(srcData.input_frames_used));
+        numGenerated += static_cast<int>(srcData.output_frames_gen);
+
+        if (srcData.input_frames_used == 0 && srcData.output_frames_gen == 0)
+            break;
     }
+
+    return numGenerated;
 }
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ScorePacket.cpp
+    Created: 19 Oct 2026 11:40:02am
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/ScorePacket.h"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace score_packet
+{
+// Every platform the plugin ships on is little-endian, so the in-memory layout is the wire layout
+static_assert(std::endian::native == std::endian::little, "ScorePacket assumes a little-endian host");
+static_assert(headerSize % alignof(uint64_t) == 0);
+
+template <typename T>
+static void writeAt(std::vector<std::byte>& packet, size_t offset, T value)
+{
+    std::memcpy(packet.data() + offset, &value, sizeof(T));
+}
+
+// A friend of ClassificationHistory, so the columns can be copied out of its ring while it's locked
+struct HistoryWriter
+{
+    static std::vector<std::byte> write(const ClassificationHistory& history, uint64_t sinceSequence,
+                                        AnalysisState state)
+    {
+        constexpr auto capacity = static_cast<uint64_t>(ClassificationHistory::capacity);
+
+        const juce::ScopedLock sl(history.lock);
+
+        const auto latest = history.latestSequence;
+        const auto oldestHeld = latest >= capacity ? latest - capacity + 1 : 1;
+        const auto first = juce::jmax(sinceSequence + 1, oldestHeld);
+        const auto numInRange = first > latest ? size_t { 0 } : static_cast<size_t>(latest - first + 1);
+
+        // Slots that haven't been written since the ring was created still hold sequence 0
+        const auto isHeld = [&](uint64_t sequence) { return history.sequences[sequence % capacity] == sequence; };
+
+        size_t numResults = 0;
+        for (size_t i = 0; i < numInRange; ++i)
+            numResults += isHeld(first + i) ? 1 : 0;
+
+        std::vector<std::byte> packet(getPacketSize(numResults));
+
+        writeAt<uint32_t>(packet, 0, static_cast<uint32_t>(state));
+        writeAt<uint32_t>(packet, 4, static_cast<uint32_t>(label_groups::numGroups));
+        writeAt<uint32_t>(packet, 8, static_cast<uint32_t>(numResults));
+        writeAt<uint32_t>(packet, 12, 0);
+
+        auto offset = headerSize;
+
+        // Each ring column goes out as at most two runs, [first's slot, end) then [0, ...), unless
+        // a sequence is missing, in which case the held rows are picked out one at a time
+        const auto writeColumn = [&](const auto& ring)
+        {
+            using Value = typename std::decay_t<decltype(ring)>::value_type;
+            auto* const dest = packet.data() + offset;
+
+            if (numResults == numInRange)
+            {
+                const auto firstSlot = static_cast<size_t>(first % capacity);
+                const auto numBeforeWrap = juce::jmin(numResults, ring.size() - firstSlot);
+
+                std::memcpy(dest, ring.data() + firstSlot, numBeforeWrap * sizeof(Value));
+                std::memcpy(dest + numBeforeWrap * sizeof(Value), ring.data(), (numResults - numBeforeWrap) * sizeof(Value));
+            }
+            else
+            {
+                auto row = size_t { 0 };
+
+                for (size_t i = 0; i < numInRange; ++i)
+                    if (isHeld(first + i))
+                        std::memcpy(dest + row++ * sizeof(Value), ring.data() + (first + i) % capacity, sizeof(Value));
+            }
+
+            offset += numResults * sizeof(Value);
+        };
+
+        writeColumn(history.sequences);
+        writeColumn(history.audioPositions);
+        writeColumn(history.timesMs);
+
+        for (const auto& column : history.groupScores)
+            writeColumn(column);
+
+        jassert(offset == packet.size());
+        return packet;
+    }
+};
+
+std::vector<std::byte> write(const ClassificationHistory& history, uint64_t sinceSequence, AnalysisState state)
+{
+    return HistoryWriter::write(history, sinceSequence, state);
+}
+}  // namespace score_packet
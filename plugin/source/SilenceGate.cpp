@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    SilenceGate.cpp
+    Created: 20 Oct 2026 10:18:52am
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/SilenceGate.h"
+
+#include <cmath>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <immintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+SilenceGate::Level SilenceGate::measure(std::span<const float> samples) noexcept
+{
+    if (samples.empty())
+        return {};
+
+    const auto numSamples = static_cast<int>(samples.size());
+    const auto range = juce::FloatVectorOperations::findMinAndMax(samples.data(), numSamples);
+
+    return { juce::jmax(-range.getStart(), range.getEnd()),
+             std::sqrt(sumOfSquares(samples.data(), numSamples) / static_cast<float>(numSamples)) };
+}
+
+void SilenceGate::setThresholdsDb(float peakDb, float rmsDb) noexcept
+{
+    peakThreshold.store(juce::Decibels::decibelsToGain(peakDb), std::memory_order_relaxed);
+    rmsThreshold.store(juce::Decibels::decibelsToGain(rmsDb), std::memory_order_relaxed);
+}
+
+float SilenceGate::sumOfSquares(const float* samples, int numSamples) noexcept
+{
+    int i = 0;
+    float sum = 0.0f;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    auto acc0 = _mm_setzero_ps();
+    auto acc1 = _mm_setzero_ps();
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const auto a = _mm_loadu_ps(samples + i);
+        const auto b = _mm_loadu_ps(samples + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+
+    auto acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+   #elif JUCE_USE_ARM_NEON
+    auto acc0 = vdupq_n_f32(0.0f);
+    auto acc1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const auto a = vld1q_f32(samples + i);
+        const auto b = vld1q_f32(samples + i + 4);
+        acc0 = vmlaq_f32(acc0, a, a);
+        acc1 = vmlaq_f32(acc1, b, b);
+    }
+
+    const auto acc = vaddq_f32(acc0, acc1);
+    const auto pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+   #endif
+
+    for (; i < numSamples; ++i)
+        sum += samples[i] * samples[i];
+
+    return sum;
+}
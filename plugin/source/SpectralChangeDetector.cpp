@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    SpectralChangeDetector.cpp
+    Created: 20 Oct 2026 2:47:15pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/SpectralChangeDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SpectralChangeDetector::SpectralChangeDetector()
+{
+    window.resize(fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    // Log-spaced from bin 2 (62.5 Hz) to Nyquist, at least one bin per band
+    constexpr double firstBin = 2.0;
+    constexpr double lastBin = fftSize / 2;
+
+    for (int edge = 0; edge <= numBands; ++edge)
+    {
+        const auto bin = juce::roundToInt(firstBin * std::pow(lastBin / firstBin, static_cast<double>(edge) / numBands));
+        bandEdges[static_cast<size_t>(edge)] = edge == 0 ? bin : juce::jmax(bin, bandEdges[static_cast<size_t>(edge - 1)] + 1);
+    }
+
+    fftBuffer.resize(2 * fftSize);
+    frame.resize(fftSize);
+
+    reset();
+}
+
+void SpectralChangeDetector::reset()
+{
+    frameFill = 0;
+    currentHopPower.fill(0.0f);
+    currentHopFrames = 0;
+    hopPower = {};
+    hopFrames.fill(0);
+    nextHop = 0;
+    latestWindowDb.fill(0.0f);
+    hasReference = false;
+}
+
+void SpectralChangeDetector::pushSamples(std::span<const float> samples)
+{
+    while (!samples.empty())
+    {
+        const auto numToCopy = juce::jmin(samples.size(), static_cast<size_t>(fftSize - frameFill));
+        std::copy_n(samples.data(), numToCopy, frame.data() + frameFill);
+
+        frameFill += static_cast<int>(numToCopy);
+        samples = samples.subspan(numToCopy);
+
+        if (frameFill == fftSize)
+        {
+            computeFrame();
+            frameFill = 0;
+        }
+    }
+}
+
+void SpectralChangeDetector::computeFrame()
+{
+    juce::FloatVectorOperations::multiply(fftBuffer.data(), frame.data(), window.data(), fftSize);
+    std::fill(fftBuffer.begin() + fftSize, fftBuffer.end(), 0.0f);
+
+    fft.performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        float power = 0.0f;
+
+        for (int bin = bandEdges[static_cast<size_t>(band)]; bin < bandEdges[static_cast<size_t>(band + 1)]; ++bin)
+            power += fftBuffer[static_cast<size_t>(bin)] * fftBuffer[static_cast<size_t>(bin)];
+
+        currentHopPower[static_cast<size_t>(band)] += power;
+    }
+
+    ++currentHopFrames;
+}
+
+void SpectralChangeDetector::endHop()
+{
+    hopPower[static_cast<size_t>(nextHop)] = currentHopPower;
+    hopFrames[static_cast<size_t>(nextHop)] = currentHopFrames;
+    nextHop = (nextHop + 1) % maxHopsPerWindow;
+
+    currentHopPower.fill(0.0f);
+    currentHopFrames = 0;
+
+    // Sum the window's hops, newest first
+    std::array<float, numBands> windowPower {};
+    int windowFrames = 0;
+
+    for (int i = 1; i <= hopsPerWindow; ++i)
+    {
+        const auto hop = static_cast<size_t>((nextHop - i + maxHopsPerWindow) % maxHopsPerWindow);
+
+        for (size_t band = 0; band < numBands; ++band)
+            windowPower[band] += hopPower[hop][band];
+
+        windowFrames += hopFrames[hop];
+    }
+
+    // The floor keeps digital silence from producing huge dB differences over nothing
+    constexpr float powerFloor = 1.0e-10f;
+
+    for (size_t band = 0; band < numBands; ++band)
+        latestWindowDb[band] = 10.0f * std::log10(windowPower[band] / static_cast<float>(juce::jmax(1, windowFrames)) + powerFloor);
+}
+
+float SpectralChangeDetector::getDistanceFromReferenceDb() const noexcept
+{
+    if (!hasReference)
+        return std::numeric_limits<float>::infinity();
+
+    float distance = 0.0f;
+
+    for (size_t band = 0; band < numBands; ++band)
+        distance = std::max(distance, std::abs(latestWindowDb[band] - referenceDb[band]));
+
+    return distance;
+}
+
+void SpectralChangeDetector::setReferenceToLatestWindow() noexcept
+{
+    referenceDb = latestWindowDb;
+    hasReference = true;
+}
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    Trace.cpp
+    Created: 18 Oct 2026 7:02:26pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/Trace.h"
+
+#if AQUA_TRACING
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace trace
+{
+namespace
+{
+constexpr int maxThreads = 32;
+constexpr uint64_t eventsPerThread = 4096;
+constexpr size_t maxThreadNameLength = 32;
+
+// One event, guarded by a sequence number: odd while the owning thread is writing it, and
+// 2 * (index + 1) once event number index is complete. The fields are relaxed atomics so the
+// exporter can read them while they're being overwritten and simply discard torn copies.
+struct Slot
+{
+    std::atomic<uint64_t> sequence { 0 };
+    std::atomic<const char*> name { nullptr };
+    std::atomic<juce::int64> startTicks { 0 };
+    std::atomic<juce::int64> endTicks { 0 };
+};
+
+struct ThreadBuffer
+{
+    std::atomic<bool> inUse { false };
+    std::atomic<uint64_t> threadId { 0 };     // Unique per claim; 0 while unclaimed
+
+    // A copy, since a juce::Thread's name goes when the thread does. Odd nameVersion while it's
+    // being written.
+    std::atomic<uint32_t> nameVersion { 0 };
+    std::array<char, maxThreadNameLength> threadName {};
+    std::atomic<uint64_t> numWritten { 0 };
+    std::atomic<uint64_t> claimStart { 0 };   // Events before this belong to an earlier thread
+    std::array<Slot, eventsPerThread> slots;
+
+    uint64_t numExported = 0;                 // Exporter only, under exportLock
+};
+
+std::array<ThreadBuffer, maxThreads> buffers;
+std::atomic<uint64_t> nextThreadId { 1 };
+juce::CriticalSection exportLock;
+
+// Hands the buffer back when its thread exits. Its events stay until they're exported or
+// another thread claims it.
+struct BufferClaim
+{
+    ThreadBuffer* buffer = nullptr;
+    bool hasTried = false;
+
+    ~BufferClaim()
+    {
+        if (buffer != nullptr)
+            buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local BufferClaim claim;
+
+void writeThreadName(ThreadBuffer& buffer, const char* name) noexcept
+{
+    buffer.nameVersion.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::strncpy(buffer.threadName.data(), name, maxThreadNameLength - 1);
+
+    buffer.nameVersion.fetch_add(1, std::memory_order_release);
+}
+
+juce::String readThreadName(const ThreadBuffer& buffer)
+{
+    const auto version = buffer.nameVersion.load(std::memory_order_acquire);
+    auto name = buffer.threadName;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if ((version & 1) != 0 || buffer.nameVersion.load(std::memory_order_relaxed) != version || name[0] == 0)
+        return "Unnamed thread";
+
+    name.back() = 0;
+    return juce::String::fromUTF8(name.data());
+}
+
+bool tryClaim(ThreadBuffer& buffer) noexcept
+{
+    if (buffer.inUse.exchange(true, std::memory_order_acq_rel))
+        return false;
+
+    buffer.claimStart.store(buffer.numWritten.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const char* name = "";
+
+    if (auto* thread = juce::Thread::getCurrentThread())
+        name = thread->getThreadName().toRawUTF8();
+
+    writeThreadName(buffer, name);
+    buffer.threadId.store(nextThreadId.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+    return true;
+}
+
+ThreadBuffer* getThreadBuffer() noexcept
+{
+    if (claim.hasTried)
+        return claim.buffer;
+
+    claim.hasTried = true;
+
+    // Buffers that have never been used go first, so a thread that has exited keeps its events
+    // for as long as possible
+    for (auto& buffer : buffers)
+        if (buffer.threadId.load(std::memory_order_relaxed) == 0 && tryClaim(buffer))
+            return claim.buffer = &buffer;
+
+    for (auto& buffer : buffers)
+        if (tryClaim(buffer))
+            return claim.buffer = &buffer;
+
+    return nullptr; // Every buffer is taken, so this thread goes untraced
+}
+
+void appendEscaped(juce::MemoryOutputStream& out, const char* text)
+{
+    for (; *text != 0; ++text)
+    {
+        if (*text == '"' || *text == '\\')
+            out << '\\';
+
+        out << *text;
+    }
+}
+} // namespace
+
+void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    auto* buffer = getThreadBuffer();
+
+    if (buffer == nullptr)
+        return;
+
+    const auto index = buffer->numWritten.load(std::memory_order_relaxed);
+    auto& slot = buffer->slots[index % eventsPerThread];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startTicks.store(startTicks, std::memory_order_relaxed);
+    slot.endTicks.store(endTicks, std::memory_order_relaxed);
+
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    buffer->numWritten.store(index + 1, std::memory_order_release);
+}
+
+void setThreadName(const char* name) noexcept
+{
+    if (auto* buffer = getThreadBuffer(); buffer != nullptr && buffer->threadName[0] == 0)
+        writeThreadName(*buffer, name);
+}
+
+bool writeChromeTrace(const juce::File& file)
+{
+    const juce::ScopedLock sl(exportLock);
+
+    const auto ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e6;
+    juce::MemoryOutputStream out;
+    auto isFirst = true;
+
+    const auto separator = [&]
+    {
+        if (!std::exchange(isFirst, false))
+            out << ",\n";
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    for (auto& buffer : buffers)
+    {
+        const auto threadId = buffer.threadId.load(std::memory_order_acquire);
+
+        if (threadId == 0)
+            continue;
+
+        const auto numWritten = buffer.numWritten.load(std::memory_order_acquire);
+        const auto claimStart = buffer.claimStart.load(std::memory_order_relaxed);
+        const auto oldestKept = numWritten > eventsPerThread ? numWritten - eventsPerThread : 0;
+        auto first = juce::jmax(buffer.numExported, claimStart, oldestKept);
+
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << static_cast<juce::int64>(threadId) << ",\"args\":{\"name\":\"";
+        appendEscaped(out, readThreadName(buffer).toRawUTF8());
+        out << "\"}}";
+
+        for (auto index = first; index < numWritten; ++index)
+        {
+            const auto& slot = buffer.slots[index % eventsPerThread];
+
+            if (slot.sequence.load(std::memory_order_acquire) != 2 * (index + 1))
+                continue;
+
+            const auto* name = slot.name.load(std::memory_order_relaxed);
+            const auto startTicks = slot.startTicks.load(std::memory_order_relaxed);
+            const auto endTicks = slot.endTicks.load(std::memory_order_relaxed);
+
+            // Overwritten while it was being copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) != 2 * (index + 1) || name == nullptr)
+                continue;
+
+            separator();
+            out << "{\"name\":\"";
+            appendEscaped(out, name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << static_cast<juce::int64>(threadId)
+                << ",\"ts\":" << juce::String(static_cast<double>(startTicks) / ticksPerMicrosecond, 3)
+                << ",\"dur\":" << juce::String(static_cast<double>(endTicks - startTicks) / ticksPerMicrosecond, 3) << "}";
+        }
+
+        buffer.numExported = numWritten;
+    }
+
+    out << "\n]}\n";
+
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+} // namespace trace
+
+#else
+
+bool trace::writeChromeTrace(const juce::File&)
+{
+    return false;
+}
+
+#endif
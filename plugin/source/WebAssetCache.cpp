@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    WebAssetCache.cpp
+    Created: 19 Oct 2026 4:31:10pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AQUA/WebAssetCache.h"
+#include "AQUA/RealtimeLog.h"
+
+#include <JuceHeader.h>
+#include <WebViewFiles.h>
+#include <algorithm>
+
+static const char* getMimeForExtension(const juce::String& extension)
+{
+    static const std::unordered_map<juce::String, const char*> mimeMap = {
+        {{"htm"}, "text/html"},
+        {{"html"}, "text/html"},
+        {{"txt"}, "text/plain"},
+        {{"jpg"}, "image/jpeg"},
+        {{"jpeg"}, "image/jpeg"},
+        {{"svg"}, "image/svg+xml"},
+        {{"ico"}, "image/vnd.microsoft.icon"},
+        {{"json"}, "application/json"},
+        {{"png"}, "image/png"},
+        {{"css"}, "text/css"},
+        {{"map"}, "application/json"},
+        {{"js"}, "text/javascript"},
+        {{"woff2"}, "font/woff2"}};
+
+    if (const auto it = mimeMap.find(extension.toLowerCase()); it != mimeMap.end())
+        return it->second;
+
+    return "application/octet-stream";
+}
+
+//===============================================================================================
+const WebAssetCache& WebAssetCache::getInstance()
+{
+    static const WebAssetCache instance;
+    return instance;
+}
+
+WebAssetCache::WebAssetCache()
+{
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    juce::MemoryInputStream zipStream { webview_files::webview_files_zip,
+                                        static_cast<size_t>(webview_files::webview_files_zipSize),
+                                        false };
+    juce::ZipFile zipFile { zipStream };
+
+    for (int i = 0; i < zipFile.getNumEntries(); ++i)
+    {
+        const auto* entry = zipFile.getEntry(i);
+        const auto path = normalise(entry->filename.toStdString());
+
+        if (path.empty() || path.back() == '/')
+            continue; // Directory
+
+        const std::unique_ptr<juce::InputStream> entryStream { zipFile.createStreamForEntry(*entry) };
+        if (entryStream == nullptr)
+            continue;
+
+        auto asset = std::make_shared<Asset>();
+        asset->mimeType = getMimeForExtension(juce::String(path).fromLastOccurrenceOf(".", false, false));
+
+        juce::MemoryBlock contents;
+        entryStream->readIntoMemoryBlock(contents);
+        const auto* data = static_cast<const std::byte*>(contents.getData());
+        asset->bytes.assign(data, data + contents.getSize());
+
+        // Earlier entries win, as they did when the zip was searched in order
+        const std::shared_ptr<const Asset> shared = std::move(asset);
+        for (size_t start = 0; start != std::string::npos;)
+        {
+            assets.try_emplace(path.substr(start), shared);
+
+            const auto slash = path.find('/', start);
+            start = slash == std::string::npos ? slash : slash + 1;
+        }
+
+        ++numAssets;
+    }
+
+    buildTimeMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+    RealtimeLog::info("Unpacked %d web assets in %.1f ms.", static_cast<int>(numAssets), buildTimeMs);
+}
+
+std::string WebAssetCache::normalise(std::string_view path)
+{
+    path = path.substr(0, path.find_first_of("?#"));
+
+    std::string normalised { path };
+    std::replace(normalised.begin(), normalised.end(), '\\', '/');
+
+    const auto firstNonSlash = normalised.find_first_not_of('/');
+    return firstNonSlash == std::string::npos ? std::string {} : normalised.substr(firstNonSlash);
+}
+
+std::shared_ptr<const WebAssetCache::Asset> WebAssetCache::find(std::string_view path) const
+{
+    if (const auto it = assets.find(normalise(path)); it != assets.end())
+        return it->second;
+
+    return nullptr;
+}
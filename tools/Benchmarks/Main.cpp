@@ -0,0 +1,775 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 6:17:40pm
+    Author:  William Wedgwood
+
+    Microbenchmarks for each stage of the analysis path, at each common host
+    rate. Every stage is timed on its own, in batches of at least a
+    millisecond, and the median of several trials is kept. Results go to
+    stdout as JSON, one record per stage, variant and rate.
+
+    Costs are normalised to host-rate samples: per block for the stages that
+    run per block, and per hop at the default detection rate for those that
+    run once a window, so the records can be added up to see where the time
+    goes. Heap allocations made on any thread during a stage are counted too
+    (see tools/Common/AllocationCounter.h); tools/Checks asserts on them.
+
+    Model session creation is timed separately, cold against an empty
+    optimised model cache and warm against the one that load populated, and
+    reported with the model rather than per rate. So is delivery: the message
+    thread's cost per second of getting results to the UI, by polling every
+    60 ms as the editor used to and by pushing one event per result.
+
+    Options, all in --name=value form:
+      --stages=<a,b,...>         Only these stages (default all): ingestion,
+                                 resampler, silenceGate, logMel, spectralChange,
+                                 linearisation, inference, groupReduction,
+                                 serialisation, sessionCreation, delivery
+      --sample-rates=<a,b,...>   Default 44100,48000,88200,96000
+      --block-size=<samples>     Default 512
+      --ingestion-block-sizes=<a,b,...>
+                                 Buffer sizes for the ingestion stage's variants,
+                                 default 32,128,1024
+      --min-time-ms=<ms>         Minimum time per trial, default 250
+      --trials=<n>               Default 5
+      --model-dir=<dir>          Where to look for the ONNX models
+      --model-timeout=<s>        How long to wait for the model, default 60
+      --output=<file>            Write the report to a file as well
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "AQUA/AudioClassification.h"
+#include "AQUA/LabelGroups.h"
+#include "AQUA/LogMelFrontend.h"
+#include "AQUA/SampleRateConversion.h"
+#include "AQUA/ScorePacket.h"
+#include "AQUA/SilenceGate.h"
+#include "AQUA/SpectralChangeDetector.h"
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    juce::StringArray stages;
+    std::vector<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0 };
+    int blockSize = 512;
+    std::vector<int> ingestionBlockSizes { 32, 128, 1024 };
+    double minTimeMs = 250.0;
+    int numTrials = 5;
+    double modelTimeoutSeconds = 60.0;
+    juce::File output;
+
+    bool shouldRun(const juce::String& stage) const { return stages.isEmpty() || stages.contains(stage); }
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+
+    if (args.containsOption("--stages"))
+        options.stages = juce::StringArray::fromTokens(args.getValueForOption("--stages"), ",", {});
+
+    if (args.containsOption("--sample-rates"))
+    {
+        options.sampleRates.clear();
+
+        for (const auto& rate : juce::StringArray::fromTokens(args.getValueForOption("--sample-rates"), ",", {}))
+            options.sampleRates.push_back(rate.getDoubleValue());
+    }
+
+    if (args.containsOption("--block-size"))
+        options.blockSize = args.getValueForOption("--block-size").getIntValue();
+
+    if (args.containsOption("--ingestion-block-sizes"))
+    {
+        options.ingestionBlockSizes.clear();
+
+        for (const auto& size : juce::StringArray::fromTokens(args.getValueForOption("--ingestion-block-sizes"), ",", {}))
+            options.ingestionBlockSizes.push_back(juce::jmax(1, size.getIntValue()));
+    }
+
+    if (args.containsOption("--min-time-ms"))
+        options.minTimeMs = args.getValueForOption("--min-time-ms").getDoubleValue();
+
+    if (args.containsOption("--trials"))
+        options.numTrials = juce::jmax(1, args.getValueForOption("--trials").getIntValue());
+
+    if (args.containsOption("--model-timeout"))
+        options.modelTimeoutSeconds = args.getValueForOption("--model-timeout").getDoubleValue();
+
+    if (args.containsOption("--model-dir"))
+        InferenceService::setModelDirectory(juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--model-dir")));
+
+    if (args.containsOption("--output"))
+        options.output = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+    return options;
+}
+
+//===============================================================================================
+struct Measurement
+{
+    double nsPerOp = 0.0;
+    double allocationsPerOp = 0.0;
+    juce::int64 iterations = 0;
+};
+
+double ticksToNs(juce::int64 ticks)
+{
+    return 1.0e9 * juce::Time::highResolutionTicksToSeconds(ticks);
+}
+
+// Runs op in batches long enough to swamp the timer, for at least minTimeMs per trial, and keeps
+// the median trial
+template <typename Operation>
+Measurement measure(Operation&& op, const Options& options)
+{
+    const auto timeBatch = [&op](juce::int64 batchSize)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (juce::int64 i = 0; i < batchSize; ++i)
+            op();
+
+        return ticksToNs(juce::Time::getHighResolutionTicks() - start);
+    };
+
+    juce::int64 batchSize = 1;
+
+    while (timeBatch(batchSize) < 1.0e6 && batchSize < (juce::int64 { 1 } << 30))
+        batchSize *= 2;
+
+    std::vector<double> trialNsPerOp;
+    Measurement measurement;
+    const auto allocationsBefore = allocation_counter::getNumAllocations();
+
+    for (int trial = 0; trial < options.numTrials; ++trial)
+    {
+        auto elapsedNs = 0.0;
+        juce::int64 iterations = 0;
+
+        while (elapsedNs < options.minTimeMs * 1.0e6)
+        {
+            elapsedNs += timeBatch(batchSize);
+            iterations += batchSize;
+        }
+
+        trialNsPerOp.push_back(elapsedNs / static_cast<double>(iterations));
+        measurement.iterations += iterations;
+    }
+
+    std::sort(trialNsPerOp.begin(), trialNsPerOp.end());
+    measurement.nsPerOp = trialNsPerOp[trialNsPerOp.size() / 2];
+    measurement.allocationsPerOp = static_cast<double>(allocation_counter::getNumAllocations() - allocationsBefore)
+                                   / static_cast<double>(measurement.iterations);
+    return measurement;
+}
+
+// A standalone copy of the per-sample ring write that block ingestion replaced, from the old
+// AudioClassification::processSample: a modulo on the ring position and a hop check per sample.
+// At each hop it used to linearise the window and run the model right there; only the hop is
+// counted here, since the linearisation stage's moduloLoop variant times that loop on its own.
+class LegacySampleRing
+{
+public:
+    LegacySampleRing(int fifoSizeIn, int hopSizeIn)
+        : inputFifo(static_cast<size_t>(fifoSizeIn), 0.0f), fifoSize(fifoSizeIn), hopSize(hopSizeIn)
+    {
+    }
+
+    void processSample(const float sample)
+    {
+        inputFifo[static_cast<size_t>(pos)] = sample;
+        pos = (pos + 1) % fifoSize;
+
+        if (++count == hopSize)
+        {
+            count = 0;
+            ++numHops;
+        }
+    }
+
+    int getNumHops() const noexcept { return numHops; }
+
+private:
+    std::vector<float> inputFifo;
+    const int fifoSize;
+    const int hopSize;
+    int pos = 0;
+    int count = 0;
+    int numHops = 0;
+};
+
+// The audio thread's side of ingestion: blocks are timed in bursts of at most a quarter of the
+// ingest ring, and the worker is left to drain the ring (untimed) between bursts, so every sample
+// timed goes into the ring rather than down the drop path. Only this thread's allocations count.
+Measurement measureIngestion(AudioClassification& classifier, std::span<const float> block, bool perSample,
+                             double sampleRate, const Options& options)
+{
+    const auto burstSamples = juce::roundToInt(0.25 * InferenceService::waveformLength * sampleRate / 16000.0);
+    const auto blocksPerBurst = juce::jmax(1, burstSamples / static_cast<int>(block.size()));
+
+    const auto ingest = [&]
+    {
+        if (perSample)
+        {
+            // One ingest FIFO write per sample, so block against this is the FIFO's per-call cost;
+            // LegacySampleRing is the per-sample write that was actually replaced
+            for (size_t i = 0; i < block.size(); ++i)
+                classifier.processBlock(block.subspan(i, 1));
+        }
+        else
+        {
+            classifier.processBlock(block);
+        }
+    };
+
+    const auto waitForDrain = [&]
+    {
+        while (classifier.getNumPendingSamples() > 0)
+            juce::Thread::sleep(1);
+    };
+
+    std::vector<double> trialNsPerOp;
+    Measurement measurement;
+    const auto allocationsBefore = allocation_counter::getNumAllocationsOnThisThread();
+
+    for (int trial = 0; trial < options.numTrials; ++trial)
+    {
+        auto elapsedNs = 0.0;
+        juce::int64 iterations = 0;
+
+        while (elapsedNs < options.minTimeMs * 1.0e6)
+        {
+            waitForDrain();
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int i = 0; i < blocksPerBurst; ++i)
+                ingest();
+
+            elapsedNs += ticksToNs(juce::Time::getHighResolutionTicks() - start);
+            iterations += blocksPerBurst;
+        }
+
+        trialNsPerOp.push_back(elapsedNs / static_cast<double>(iterations));
+        measurement.iterations += iterations;
+    }
+
+    std::sort(trialNsPerOp.begin(), trialNsPerOp.end());
+    measurement.nsPerOp = trialNsPerOp[trialNsPerOp.size() / 2];
+    measurement.allocationsPerOp = static_cast<double>(allocation_counter::getNumAllocationsOnThisThread() - allocationsBefore)
+                                   / static_cast<double>(measurement.iterations);
+    return measurement;
+}
+
+juce::DynamicObject* makeRecord(const juce::String& stage, const juce::String& variant, double sampleRate,
+                                const Measurement& measurement, double hostSamplesPerOp)
+{
+    const auto nsPerSample = measurement.nsPerOp / hostSamplesPerOp;
+
+    auto* record = new juce::DynamicObject();
+    record->setProperty("stage", stage);
+    record->setProperty("variant", variant);
+    record->setProperty("sampleRate", sampleRate);
+    record->setProperty("iterations", measurement.iterations);
+    record->setProperty("nsPerOp", measurement.nsPerOp);
+    record->setProperty("nsPerSample", nsPerSample);
+    record->setProperty("samplesPerSecond", 1.0e9 / nsPerSample);
+    record->setProperty("realtimeFactor", 1.0e9 / nsPerSample / sampleRate);
+    record->setProperty("allocationsPerOp", measurement.allocationsPerOp);
+    return record;
+}
+
+std::vector<float> makeNoise(size_t numSamples, float level)
+{
+    juce::Random random(1234);
+    std::vector<float> samples(numSamples);
+
+    for (auto& sample : samples)
+        sample = level * (random.nextFloat() * 2.0f - 1.0f);
+
+    return samples;
+}
+
+//===============================================================================================
+// Gain of a steady tone through the converter, in dB, ignoring the first tenth of a second
+double measureToneGainDb(SampleRateConversion& converter, double sampleRate, double frequency, int blockSize)
+{
+    const auto numSamples = static_cast<int>(sampleRate);
+    std::vector<float> input(static_cast<size_t>(numSamples));
+
+    for (int i = 0; i < numSamples; ++i)
+        input[static_cast<size_t>(i)] = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+
+    std::vector<float> output;
+    std::vector<float> block(static_cast<size_t>(converter.getMaxOutputSamples(blockSize)));
+
+    for (int start = 0; start + blockSize <= numSamples; start += blockSize)
+    {
+        const auto numOut = converter.interpolateAudio({ input.data() + start, static_cast<size_t>(blockSize) }, block);
+        output.insert(output.end(), block.begin(), block.begin() + numOut);
+    }
+
+    const auto skip = output.size() / 10;
+    auto sumOfSquares = 0.0;
+
+    for (auto i = skip; i < output.size(); ++i)
+        sumOfSquares += static_cast<double>(output[i]) * output[i];
+
+    const auto outputRms = std::sqrt(sumOfSquares / static_cast<double>(juce::jmax<size_t>(1, output.size() - skip)));
+    return juce::Decibels::gainToDecibels(outputRms / (0.5 / std::sqrt(2.0)), -200.0);
+}
+
+const char* getQualityName(SampleRateConversion::Quality quality)
+{
+    switch (quality)
+    {
+        case SampleRateConversion::Quality::automatic:   return "automatic";
+        case SampleRateConversion::Quality::sincBest:    return "libsamplerate sincBest";
+        case SampleRateConversion::Quality::sincMedium:  return "libsamplerate sincMedium";
+        case SampleRateConversion::Quality::sincFastest: return "libsamplerate sincFastest";
+    }
+
+    return "unknown";
+}
+
+//===============================================================================================
+class BenchmarkClient : public InferenceService::Client
+{
+public:
+    void inferenceCompleted(std::span<const float> scores, uint64_t, juce::int64) override
+    {
+        std::copy(scores.begin(), scores.end(), lastScores.begin());
+        completed.signal();
+    }
+
+    std::array<float, ClassificationResult::numClasses> lastScores {};
+    juce::WaitableEvent completed;
+};
+
+bool waitForModel(InferenceService& service, double timeoutSeconds)
+{
+    service.startLoading();
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    while (service.getState() == InferenceService::State::loading
+           && juce::Time::getMillisecondCounterHiRes() - startMs < timeoutSeconds * 1000.0)
+    {
+        RealtimeLog::flush();
+        juce::Thread::sleep(50);
+    }
+
+    return service.isReady();
+}
+
+double getMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Each trial points the model cache at a new, empty folder and loads the model twice: the first
+// load has to optimise the graph and write the cache (cold), the second reads it back (warm).
+// Loads are whole InferenceService instances, the way a plugin instance would start one.
+juce::var measureSessionCreation(const Options& options)
+{
+    std::vector<double> coldMs, warmMs;
+    int numWarmFromCache = 0;
+
+    for (int trial = 0; trial < options.numTrials; ++trial)
+    {
+        const auto cacheDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                        .getNonexistentChildFile("AQUA_ModelCache", {}, false);
+        cacheDirectory.createDirectory();
+        InferenceService::setModelCacheDirectory(cacheDirectory);
+
+        for (const auto warm : { false, true })
+        {
+            InferenceService service;
+
+            if (!waitForModel(service, options.modelTimeoutSeconds))
+                break;
+
+            (warm ? warmMs : coldMs).push_back(service.getModelLoadTimeMs());
+
+            if (warm && service.wasLoadedFromCache())
+                ++numWarmFromCache;
+        }
+
+        cacheDirectory.deleteRecursively();
+    }
+
+    InferenceService::setModelCacheDirectory({});
+    RealtimeLog::flush();
+
+    if (coldMs.empty())
+        return {};
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("trials", static_cast<int>(coldMs.size()));
+    result->setProperty("coldMs", getMedian(coldMs));
+    result->setProperty("warmMs", getMedian(warmMs));
+    result->setProperty("warmLoadsFromCache", numWarmFromCache); // Should equal trials
+    return result;
+}
+
+// What emitEventIfBrowserIsVisible hands the WebView: the event and its id as JSON, in a script
+juce::String makeEventScript(const juce::var& payload)
+{
+    juce::DynamicObject::Ptr event { new juce::DynamicObject() };
+    event->setProperty("eventId", "yamnetOut");
+    event->setProperty("payload", payload);
+    return "window.__JUCE__.backend.emitByBackend(" + juce::JSON::toString(juce::var(event.get()), true) + ");";
+}
+
+// The "yamnetOut" event payload the editor pushes per result (see emitLatestResult)
+juce::var makeResultPayload(const ClassificationResult& result)
+{
+    juce::Array<juce::var> groups;
+    groups.ensureStorageAllocated(static_cast<int>(result.groupScores.size()));
+    for (const auto score : result.groupScores)
+        groups.add(score);
+
+    juce::DynamicObject::Ptr payload { new juce::DynamicObject() };
+    payload->setProperty("sequence", static_cast<juce::int64>(result.sequence));
+    payload->setProperty("audioPosition", static_cast<juce::int64>(result.audioPosition));
+    payload->setProperty("time", result.timeMs);
+    payload->setProperty("status", "running");
+    payload->setProperty("groups", groups);
+    return payload.get();
+}
+
+// The editor's old yamnetOut.json response, built the way it used to on every poll: a var per class
+// score, JSON text, then copied through a MemoryInputStream into the response body
+std::vector<std::byte> makeLegacyJsonResponse(const ClassificationResult& result)
+{
+    juce::Array<juce::var> scoresArray;
+    for (const auto score : result.scores)
+        scoresArray.add(score);
+
+    juce::DynamicObject::Ptr levelData { new juce::DynamicObject() };
+    levelData->setProperty("scores", scoresArray);
+
+    const auto jsonString = juce::JSON::toString(levelData.get());
+    juce::MemoryInputStream stream { jsonString.getCharPointer(), jsonString.getNumBytesAsUTF8(), false };
+
+    std::vector<std::byte> response(static_cast<size_t>(stream.getTotalLength()));
+    stream.read(response.data(), static_cast<int>(response.size()));
+    return response;
+}
+
+// The message thread's share of getting results to the UI, before and after results were pushed.
+// Polling emitted an empty event every 60 ms and served the fetch it triggered; pushing emits one
+// event per result with the scores attached, and nothing is fetched. The WebView's side isn't
+// measured here (that needs a real browser engine); fetchesPerSecond is what it's spared.
+juce::var measureDelivery(const Options& options)
+{
+    constexpr double pollIntervalMs = 60.0;
+
+    ClassificationResult result;
+    result.sequence = 1;
+    const auto noise = makeNoise(ClassificationResult::numClasses, 1.0f);
+    std::copy(noise.begin(), noise.end(), result.scores.begin());
+    label_groups::reduce(result.scores, result.groupScores);
+
+    const auto polling = measure([&]
+    {
+        juce::ignoreUnused(makeEventScript(juce::var()));
+        juce::ignoreUnused(makeLegacyJsonResponse(result));
+    }, options);
+
+    const auto pushing = measure([&] { juce::ignoreUnused(makeEventScript(makeResultPayload(result))); }, options);
+
+    const auto makeVariant = [](const Measurement& measurement, double updatesPerSecond, double fetchesPerSecond)
+    {
+        auto* variant = new juce::DynamicObject();
+        variant->setProperty("usPerUpdate", measurement.nsPerOp * 1.0e-3);
+        variant->setProperty("allocationsPerUpdate", measurement.allocationsPerOp);
+        variant->setProperty("updatesPerSecond", updatesPerSecond);
+        variant->setProperty("fetchesPerSecond", fetchesPerSecond);
+        variant->setProperty("messageThreadMsPerSecond", measurement.nsPerOp * 1.0e-6 * updatesPerSecond);
+        return variant;
+    };
+
+    const auto pollsPerSecond = 1000.0 / pollIntervalMs;
+    const auto resultsPerSecond = AudioClassification::defaultDetectionRateHz;
+
+    auto* delivery = new juce::DynamicObject();
+    delivery->setProperty("polling", makeVariant(polling, pollsPerSecond, pollsPerSecond));
+    delivery->setProperty("push", makeVariant(pushing, resultsPerSecond, 0.0));
+    delivery->setProperty("messageThreadSpeedup", (polling.nsPerOp * pollsPerSecond) / (pushing.nsPerOp * resultsPerSecond));
+    return delivery;
+}
+} // namespace
+
+//===============================================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const auto options = parseOptions(juce::ArgumentList(argc, argv));
+
+    if (options.blockSize <= 0 || options.sampleRates.empty())
+    {
+        std::cerr << "Block size and sample rates must be given." << std::endl;
+        return 1;
+    }
+
+    constexpr double analysisSampleRate = 16000.0;
+    const auto hopSize = static_cast<int>(std::round(analysisSampleRate / AudioClassification::defaultDetectionRateHz));
+    const auto fifoSize = static_cast<int>(InferenceService::waveformLength);
+    const auto blockSize = static_cast<size_t>(options.blockSize);
+
+    const auto hostBlock = makeNoise(blockSize, 0.3f);
+    const auto analysisHop = makeNoise(static_cast<size_t>(hopSize), 0.3f);
+
+    // Before the shared instance exists, so every load it times starts from nothing
+    const auto sessionCreation = options.shouldRun("sessionCreation") ? measureSessionCreation(options) : juce::var();
+    const auto delivery = options.shouldRun("delivery") ? measureDelivery(options) : juce::var();
+
+    juce::SharedResourcePointer<InferenceService> inferenceService;
+    const auto needsModel = options.shouldRun("inference");
+    const auto modelReady = needsModel && waitForModel(*inferenceService, options.modelTimeoutSeconds);
+
+    juce::Array<juce::var> records;
+
+    for (const auto sampleRate : options.sampleRates)
+    {
+        // Host samples that arrive per hop, for the stages that run once a window
+        const auto hostSamplesPerHop = hopSize * sampleRate / analysisSampleRate;
+
+        if (options.shouldRun("ingestion"))
+        {
+            // The real audio-thread entry point, one ring write per block against one per sample,
+            // with the analysis worker draining behind it, and the per-sample ring write it replaced
+            for (const auto ingestionBlockSize : options.ingestionBlockSizes)
+            {
+                const auto ingestionBlock = makeNoise(static_cast<size_t>(ingestionBlockSize), 0.3f);
+
+                for (const auto perSample : { true, false })
+                {
+                    AudioClassification classifier;
+                    classifier.prepareToPlay(sampleRate, ingestionBlockSize, AudioClassification::defaultDetectionRateHz);
+
+                    const auto measurement = measureIngestion(classifier, ingestionBlock, perSample, sampleRate, options);
+                    auto* record = makeRecord("ingestion", perSample ? "fifoPerSample" : "block", sampleRate, measurement, ingestionBlockSize);
+                    record->setProperty("blockSize", ingestionBlockSize);
+                    record->setProperty("droppedSamples", classifier.getNumDroppedSamples());
+                    records.add(record);
+
+                    classifier.releaseResources();
+                }
+
+                LegacySampleRing legacyRing(fifoSize, hopSize);
+
+                const auto legacy = measure([&]
+                {
+                    for (const auto sample : ingestionBlock)
+                        legacyRing.processSample(sample);
+                }, options);
+
+                auto* record = makeRecord("ingestion", "legacyPerSample", sampleRate, legacy, ingestionBlockSize);
+                record->setProperty("blockSize", ingestionBlockSize);
+                record->setProperty("hops", legacyRing.getNumHops());
+                records.add(record);
+            }
+        }
+
+        if (options.shouldRun("resampler"))
+        {
+            using Quality = SampleRateConversion::Quality;
+
+            for (const auto quality : { Quality::automatic, Quality::sincBest, Quality::sincMedium, Quality::sincFastest })
+            {
+                SampleRateConversion converter;
+                converter.prepareToPlay(sampleRate, analysisSampleRate, quality);
+
+                // Without an exact ratio, automatic is just libsamplerate's sincBest again
+                if (quality == Quality::automatic && !converter.isUsingPolyphase())
+                    continue;
+
+                std::vector<float> output(static_cast<size_t>(converter.getMaxOutputSamples(options.blockSize)));
+                const auto measurement = measure([&] { converter.interpolateAudio(hostBlock, output); }, options);
+
+                auto* record = makeRecord("resampler", converter.isUsingPolyphase() ? "polyphase" : getQualityName(quality),
+                                          sampleRate, measurement, options.blockSize);
+
+                // 1 kHz should pass untouched; 12 kHz is above the 8 kHz Nyquist and should vanish
+                converter.reset();
+                record->setProperty("passbandGainDb", measureToneGainDb(converter, sampleRate, 1000.0, options.blockSize));
+                converter.reset();
+                record->setProperty("aliasGainDb", measureToneGainDb(converter, sampleRate, 12000.0, options.blockSize));
+                records.add(record);
+            }
+        }
+
+        if (options.shouldRun("silenceGate"))
+        {
+            const auto measurement = measure([&] { juce::ignoreUnused(SilenceGate::measure(hostBlock)); }, options);
+            records.add(makeRecord("silenceGate", "measure", sampleRate, measurement, options.blockSize));
+        }
+
+        if (options.shouldRun("logMel"))
+        {
+            LogMelFrontend frontend;
+            std::vector<float> patch(LogMelFrontend::patchSize);
+
+            const auto measurement = measure([&]
+            {
+                frontend.pushSamples(analysisHop);
+                frontend.copyPatch(patch);
+            }, options);
+
+            records.add(makeRecord("logMel", "hop", sampleRate, measurement, hostSamplesPerHop));
+        }
+
+        if (options.shouldRun("spectralChange"))
+        {
+            SpectralChangeDetector detector;
+
+            const auto measurement = measure([&]
+            {
+                detector.pushSamples(analysisHop);
+                detector.endHop();
+                juce::ignoreUnused(detector.getDistanceFromReferenceDb());
+                detector.setReferenceToLatestWindow();
+            }, options);
+
+            records.add(makeRecord("spectralChange", "hop", sampleRate, measurement, hostSamplesPerHop));
+        }
+
+        if (options.shouldRun("linearisation"))
+        {
+            // The window ring in AudioClassification::analyseWindow: [pos, end) then [0, pos)
+            const auto ring = makeNoise(static_cast<size_t>(fifoSize), 0.3f);
+            std::vector<float> window(static_cast<size_t>(fifoSize));
+            auto pos = 0;
+
+            const auto measurement = measure([&]
+            {
+                std::copy(ring.begin() + pos, ring.end(), window.begin());
+                std::copy(ring.begin(), ring.begin() + pos, window.begin() + (fifoSize - pos));
+                pos = (pos + hopSize) % fifoSize;
+            }, options);
+
+            records.add(makeRecord("linearisation", "window", sampleRate, measurement, hostSamplesPerHop));
+
+            // What it replaced: a modulo per element, on every hop
+            const auto moduloLoop = measure([&]
+            {
+                for (int i = 0; i < fifoSize; ++i)
+                    window[static_cast<size_t>(i)] = ring[static_cast<size_t>((pos + i) % fifoSize)];
+
+                pos = (pos + hopSize) % fifoSize;
+            }, options);
+
+            records.add(makeRecord("linearisation", "moduloLoop", sampleRate, moduloLoop, hostSamplesPerHop));
+        }
+
+        if (options.shouldRun("inference") && modelReady)
+        {
+            // One window at a time with no batching wait, so this is the service's round trip
+            BenchmarkClient client;
+            const auto input = makeNoise(static_cast<size_t>(inferenceService->getInputLength()), 0.3f);
+            const auto previousBudgetMs = inferenceService->getLatencyBudgetMs();
+            inferenceService->setLatencyBudgetMs(0.0);
+            auto numRejected = 0;
+
+            const auto measurement = measure([&]
+            {
+                if (inferenceService->submit(client, input))
+                    client.completed.wait(10000);
+                else
+                    ++numRejected;
+            }, options);
+
+            inferenceService->removeClient(client);
+            inferenceService->setLatencyBudgetMs(previousBudgetMs);
+
+            auto* record = makeRecord("inference", inferenceService->getInputKind() == InferenceService::InputKind::waveform ? "waveform" : "logMelPatch",
+                                      sampleRate, measurement, hostSamplesPerHop);
+            record->setProperty("meanRunTimeMs", inferenceService->getMeanWindowRunTimeMs());
+            record->setProperty("rejectedSubmissions", numRejected);
+            records.add(record);
+        }
+
+        if (options.shouldRun("groupReduction"))
+        {
+            const auto scores = makeNoise(ClassificationResult::numClasses, 1.0f);
+            std::array<float, label_groups::numGroups> groupScores {};
+
+            const auto measurement = measure([&] { label_groups::reduce(scores, groupScores); }, options);
+            records.add(makeRecord("groupReduction", "max", sampleRate, measurement, hostSamplesPerHop));
+        }
+
+        if (options.shouldRun("serialisation"))
+        {
+            // The UI's transport: the event the editor pushes per result, and the yamnetOut.bin/<N>
+            // packet a UI fetches when it has missed one, or everything when it opens
+            ClassificationHistory history;
+            const std::array<float, label_groups::numGroups> groupScores {};
+
+            for (uint64_t sequence = 1; sequence <= ClassificationHistory::capacity; ++sequence)
+                history.push(sequence, sequence * static_cast<uint64_t>(hopSize), 0, groupScores);
+
+            const auto latest = static_cast<uint64_t>(ClassificationHistory::capacity);
+
+            ClassificationResult result;
+            result.sequence = latest;
+
+            const auto event = measure([&] { juce::ignoreUnused(makeEventScript(makeResultPayload(result))); }, options);
+            records.add(makeRecord("serialisation", "resultEvent", sampleRate, event, hostSamplesPerHop));
+
+            const auto newResult = measure([&] { juce::ignoreUnused(score_packet::write(history, latest - 1, AnalysisState::running)); }, options);
+            records.add(makeRecord("serialisation", "packetNewResult", sampleRate, newResult, hostSamplesPerHop));
+
+            // A reopened editor catching up on the whole history in one fetch, per result
+            const auto fullHistory = measure([&] { juce::ignoreUnused(score_packet::write(history, 0, AnalysisState::running)); }, options);
+            records.add(makeRecord("serialisation", "packetFullHistory", sampleRate, fullHistory,
+                                   hostSamplesPerHop * ClassificationHistory::capacity));
+        }
+
+        RealtimeLog::flush();
+    }
+
+    // ===== Report =====
+    auto* model = new juce::DynamicObject();
+    model->setProperty("state", !needsModel ? "skipped" : modelReady ? "ready" : "unavailable");
+
+    if (modelReady)
+    {
+        // This process's shared instance, loaded from whatever the user's cache already held
+        model->setProperty("loadTimeMs", inferenceService->getModelLoadTimeMs());
+        model->setProperty("fromCache", inferenceService->wasLoadedFromCache());
+        model->setProperty("batching", inferenceService->supportsBatching());
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    report->setProperty("blockSize", options.blockSize);
+    report->setProperty("detectionRateHz", AudioClassification::defaultDetectionRateHz);
+    model->setProperty("sessionCreation", sessionCreation);
+    report->setProperty("model", model);
+    report->setProperty("delivery", delivery);
+    report->setProperty("results", records);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+    std::cout << json << std::endl;
+
+    if (options.output != juce::File() && !options.output.replaceWithText(json))
+        std::cerr << "Could not write " << options.output.getFullPathName() << std::endl;
+
+    RealtimeLog::flushAll();
+    return 0;
+}
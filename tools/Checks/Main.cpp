@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 2:41:55pm
+    Author:  William Wedgwood
+
+    Pass/fail checks of the processor core's realtime guarantees, run by
+    CTest. Each check prints one line and the process exits with 0 if every
+    check passed, 1 if any failed, or 77 (CTest's skip code) if the ones
+    that ran all needed a model that wasn't there.
+
+      processBlockAllocations  The host's audio thread makes no heap
+                               allocations in processBlock once prepared
+      runAllocations           A steady-state inference round trip, submit()
+                               through ONNX Runtime's Run to the result, makes
+                               no heap allocations on any thread (needs a model)
+      silenceGateReopens       Quiet but real material that the silence gate
+                               closes on is caught by the gate's periodic
+                               check, and the model runs on it again (needs
+                               a model)
+
+    See tools/Common/AllocationCounter.h for which allocations are visible.
+
+    Options, all in --name=value form:
+      --checks=<a,b,...>         Only these checks (default all)
+      --model-dir=<dir>          Where to look for the ONNX models
+      --model-timeout=<s>        How long to wait for the model, default 60
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "AQUA/AudioClassification.h"
+#include "AQUA/PluginProcessor.h"
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+enum class Outcome
+{
+    passed,
+    failed,
+    skipped
+};
+
+struct Options
+{
+    juce::StringArray checks;
+    double modelTimeoutSeconds = 60.0;
+
+    bool shouldRun(const juce::String& check) const { return checks.isEmpty() || checks.contains(check); }
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+
+    if (args.containsOption("--checks"))
+        options.checks = juce::StringArray::fromTokens(args.getValueForOption("--checks"), ",", {});
+
+    if (args.containsOption("--model-timeout"))
+        options.modelTimeoutSeconds = args.getValueForOption("--model-timeout").getDoubleValue();
+
+    if (args.containsOption("--model-dir"))
+        InferenceService::setModelDirectory(juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--model-dir")));
+
+    return options;
+}
+
+Outcome report(const char* check, Outcome outcome, const juce::String& detail)
+{
+    static constexpr const char* outcomeNames[] = { "PASS", "FAIL", "SKIP" };
+    std::cout << outcomeNames[static_cast<int>(outcome)] << " " << check << ": " << detail << std::endl;
+    return outcome;
+}
+
+void fillNoise(juce::AudioBuffer<float>& buffer, juce::Random& random, float level)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(channel, i, level * (random.nextFloat() * 2.0f - 1.0f));
+}
+
+bool waitForModel(InferenceService& service, double timeoutSeconds)
+{
+    service.startLoading();
+    const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+    while (service.getState() == InferenceService::State::loading
+           && juce::Time::getMillisecondCounterHiRes() - startMs < timeoutSeconds * 1000.0)
+    {
+        RealtimeLog::flush();
+        juce::Thread::sleep(50);
+    }
+
+    return service.isReady();
+}
+
+//===============================================================================================
+Outcome checkProcessBlockAllocations()
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numWarmUpBlocks = 100;
+    constexpr int numBlocks = 2000; // ~20 secs of audio, through several hops and window analyses
+
+    webview_plugin::AudioPluginAudioProcessor processor;
+    processor.getAudioClassification().addConsumer();
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(1234);
+
+    // Paced so the worker keeps up, as it would behind a real host
+    const auto runBlock = [&]
+    {
+        fillNoise(block, random, 0.3f);
+        processor.processBlock(block, midi);
+        juce::Thread::sleep(1);
+    };
+
+    for (int i = 0; i < numWarmUpBlocks; ++i)
+        runBlock();
+
+    // Only this thread's allocations count: it stands in for the host's audio thread
+    uint64_t numAllocations = 0;
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        fillNoise(block, random, 0.3f);
+
+        const auto before = allocation_counter::getNumAllocationsOnThisThread();
+        processor.processBlock(block, midi);
+        numAllocations += allocation_counter::getNumAllocationsOnThisThread() - before;
+
+        juce::Thread::sleep(1);
+    }
+
+    processor.releaseResources();
+    processor.getAudioClassification().removeConsumer();
+    RealtimeLog::flush();
+
+    return report("processBlockAllocations", numAllocations == 0 ? Outcome::passed : Outcome::failed,
+                  juce::String(static_cast<juce::int64>(numAllocations)) + " allocations in " + juce::String(numBlocks) + " blocks");
+}
+
+//===============================================================================================
+class CheckClient : public InferenceService::Client
+{
+public:
+    void inferenceCompleted(std::span<const float>, uint64_t, juce::int64) override { completed.signal(); }
+
+    juce::WaitableEvent completed;
+};
+
+Outcome checkRunAllocations(const Options& options)
+{
+    constexpr int numWarmUpRuns = 10; // Lets ORT's arena grow to its steady-state size
+    constexpr int numRuns = 50;
+
+    juce::SharedResourcePointer<InferenceService> service;
+
+    if (!waitForModel(*service, options.modelTimeoutSeconds))
+        return report("runAllocations", Outcome::skipped, "no model");
+
+    CheckClient client;
+    std::vector<float> input(static_cast<size_t>(service->getInputLength()));
+    juce::Random random(1234);
+
+    for (auto& sample : input)
+        sample = 0.3f * (random.nextFloat() * 2.0f - 1.0f);
+
+    const auto previousBudgetMs = service->getLatencyBudgetMs();
+    service->setLatencyBudgetMs(0.0);
+
+    const auto roundTrip = [&]
+    {
+        return service->submit(client, input) && client.completed.wait(10000);
+    };
+
+    for (int i = 0; i < numWarmUpRuns; ++i)
+        roundTrip();
+
+    // Nothing else runs in this process, so every allocation on any thread belongs to the round
+    // trip: the scheduler thread, ORT's intra-op pool, or this thread waiting on the result
+    const auto before = allocation_counter::getNumAllocations();
+    auto numCompleted = 0;
+
+    for (int i = 0; i < numRuns; ++i)
+        numCompleted += roundTrip() ? 1 : 0;
+
+    const auto numAllocations = allocation_counter::getNumAllocations() - before;
+
+    service->removeClient(client);
+    service->setLatencyBudgetMs(previousBudgetMs);
+    RealtimeLog::flush();
+
+    if (numCompleted != numRuns)
+        return report("runAllocations", Outcome::failed, "only " + juce::String(numCompleted) + " of " + juce::String(numRuns) + " runs completed");
+
+    return report("runAllocations", numAllocations == 0 ? Outcome::passed : Outcome::failed,
+                  juce::String(static_cast<juce::int64>(numAllocations)) + " allocations in " + juce::String(numRuns) + " runs"
+                      + (allocation_counter::isCountingMalloc() ? "" : " (ORT's own allocator not visible on this platform)"));
+}
+
+//===============================================================================================
+Outcome checkSilenceGateReopens(const Options& options)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 4096;
+    constexpr double maxAudioSeconds = 60.0; // A check comes every 64 gated windows, 8 secs at 8 Hz
+
+    juce::SharedResourcePointer<InferenceService> service;
+
+    if (!waitForModel(*service, options.modelTimeoutSeconds))
+        return report("silenceGateReopens", Outcome::skipped, "no model");
+
+    AudioClassification classifier;
+    classifier.addConsumer();
+
+    // A -26 dBFS tone over a little noise: plainly audible, but under these thresholds, so the
+    // gate closes on it as it would on real material that sits just under the defaults
+    classifier.getSilenceGate().setThresholdsDb(-20.0f, -20.0f);
+    classifier.prepareToPlay(sampleRate, blockSize, AudioClassification::maxDetectionRateHz);
+
+    std::vector<float> block(static_cast<size_t>(blockSize));
+    juce::Random random(1234);
+    double phase = 0.0;
+    const auto phaseStep = juce::MathConstants<double>::twoPi * 1000.0 / sampleRate;
+
+    const auto hasReopened = [&]
+    {
+        const auto silence = classifier.getSilenceStats();
+
+        // Reopened, and the model has since run on a window that wasn't a check
+        return silence.reopened && classifier.getThrottleStats().windowsSubmitted > silence.checksRun;
+    };
+
+    const auto numBlocks = static_cast<int>(maxAudioSeconds * sampleRate / blockSize);
+
+    for (int i = 0; i < numBlocks && !hasReopened(); ++i)
+    {
+        for (auto& sample : block)
+        {
+            sample = 0.05f * static_cast<float>(std::sin(phase)) + 0.002f * (random.nextFloat() * 2.0f - 1.0f);
+            phase += phaseStep;
+        }
+
+        classifier.processBlock(block);
+
+        // Faster than real time, but never faster than the worker drains
+        while (classifier.getNumPendingSamples() > 0)
+            juce::Thread::sleep(1);
+
+        RealtimeLog::flush();
+    }
+
+    // Give the last check's result time to come back
+    for (int i = 0; i < 100 && !hasReopened(); ++i)
+        juce::Thread::sleep(20);
+
+    const auto silence = classifier.getSilenceStats();
+    const auto windowsSubmitted = classifier.getThrottleStats().windowsSubmitted;
+
+    classifier.releaseResources();
+    classifier.removeConsumer();
+    RealtimeLog::flush();
+
+    const auto detail = juce::String(silence.windowsGated) + " windows gated, " + juce::String(silence.checksRun) + " checks ("
+                      + juce::String(silence.checksAgreed) + " agreed), " + juce::String(windowsSubmitted) + " windows submitted";
+
+    if (silence.checksRun == 0)
+        return report("silenceGateReopens", Outcome::failed, "no silence check ran: " + detail);
+
+    return report("silenceGateReopens", silence.reopened && windowsSubmitted > silence.checksRun ? Outcome::passed : Outcome::failed, detail);
+}
+} // namespace
+
+//===============================================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const auto options = parseOptions(juce::ArgumentList(argc, argv));
+
+    std::vector<Outcome> outcomes;
+
+    if (options.shouldRun("processBlockAllocations"))
+        outcomes.push_back(checkProcessBlockAllocations());
+
+    if (options.shouldRun("runAllocations"))
+        outcomes.push_back(checkRunAllocations(options));
+
+    if (options.shouldRun("silenceGateReopens"))
+        outcomes.push_back(checkSilenceGateReopens(options));
+
+    if (outcomes.empty())
+    {
+        std::cerr << "No such check." << std::endl;
+        return 1;
+    }
+
+    if (std::find(outcomes.begin(), outcomes.end(), Outcome::failed) != outcomes.end())
+        return 1;
+
+    if (std::all_of(outcomes.begin(), outcomes.end(), [](Outcome outcome) { return outcome == Outcome::skipped; }))
+        return 77;
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.cpp
+    Created: 21 Oct 2026 2:26:14pm
+    Author:  William Wedgwood
+
+  ==============================================================================
+*/
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+ #include <malloc.h>
+#endif
+
+namespace
+{
+std::atomic<uint64_t> numAllocations { 0 };
+
+// Plain data in the executable's static TLS block, so touching it never allocates
+thread_local uint64_t numAllocationsOnThisThread = 0;
+
+void countAllocation() noexcept
+{
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    ++numAllocationsOnThisThread;
+}
+} // namespace
+
+//===============================================================================================
+// glibc lets an executable interpose the C allocator for every library it loads, ORT included.
+// operator new then goes through the counted malloc, so it doesn't count again.
+#if defined(__GLIBC__)
+ #define AQUA_COUNTS_MALLOC 1
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    countAllocation();
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr ? 0 : ENOMEM;
+}
+}
+#else
+ #define AQUA_COUNTS_MALLOC 0
+#endif
+
+//===============================================================================================
+namespace
+{
+void* allocate(std::size_t size, std::size_t alignment) noexcept
+{
+   #if !AQUA_COUNTS_MALLOC
+    countAllocation();
+   #endif
+
+    size = size == 0 ? 1 : size;
+
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return std::malloc(size);
+
+   #if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+   #else
+    void* pointer = nullptr;
+    return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+   #endif
+}
+
+void* allocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (auto* pointer = allocate(size, alignment))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void deallocate(void* pointer, std::size_t alignment) noexcept
+{
+   #if defined(_WIN32)
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        _aligned_free(pointer);
+        return;
+    }
+   #else
+    (void) alignment;
+   #endif
+
+    std::free(pointer);
+}
+
+constexpr std::size_t defaultAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+} // namespace
+
+void* operator new(std::size_t size) { return allocateOrThrow(size, defaultAlignment); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size, defaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, defaultAlignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, defaultAlignment); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, defaultAlignment); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+
+//===============================================================================================
+uint64_t allocation_counter::getNumAllocations() noexcept
+{
+    return numAllocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocation_counter::getNumAllocationsOnThisThread() noexcept
+{
+    return numAllocationsOnThisThread;
+}
+
+bool allocation_counter::isCountingMalloc() noexcept
+{
+    return AQUA_COUNTS_MALLOC != 0;
+}
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.h
+    Created: 21 Oct 2026 2:26:14pm
+    Author:  William Wedgwood
+
+    Counts heap allocations in a tool's process by replacing every global
+    operator new: plain, array, nothrow and aligned. On glibc it also
+    interposes malloc, calloc, realloc and the aligned allocators, which ONNX
+    Runtime's own CPU and arena allocators call directly, so their
+    allocations are counted too.
+
+    What it can't see: direct system allocator calls elsewhere (ORT's
+    allocators on macOS and Windows, mmap, VirtualAlloc), and anything a
+    library allocates through a private allocator of its own.
+
+    Only link this into executables; it replaces the allocator for the whole
+    process.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace allocation_counter
+{
+// Allocations since the process started
+uint64_t getNumAllocations() noexcept;            // On every thread
+uint64_t getNumAllocationsOnThisThread() noexcept; // On the calling thread only
+
+// Whether the C allocator is counted too (see above)
+bool isCountingMalloc() noexcept;
+} // namespace allocation_counter
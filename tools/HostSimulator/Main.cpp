@@ -0,0 +1,653 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 5:04:12pm
+    Author:  William Wedgwood
+
+    Headless host simulator. Drives AudioPluginAudioProcessor's prepareToPlay()
+    and processBlock() the way a host would, with synthetic or file-based audio,
+    and prints a single JSON report to stdout: callback time (mean, p99, max),
+    estimated xruns against the block deadline, and inference latency. Log
+    output goes to stderr, so the report can be piped straight into a tracker.
+
+    Options, all in --name=value form:
+      --sample-rate=<Hz>         Host rate, default 48000 (or the input file's)
+      --block-size=<samples>     Default 512
+      --seconds=<s>              Length of the run, default 30
+      --input=<file>             Audio file to play, looped; otherwise --signal
+      --signal=<name>            mixed (default), tone, noise or silence
+      --detection-rate=<Hz>      Results per second, default the plugin default
+      --detection-rates=<a,...>  Run once per rate and report callback load and
+                                 inference CPU for each, as a table on stderr too
+      --compare-always-on        Run twice on the same input, with result reuse
+                                 and with it off, and report how closely the
+                                 reused results match always-on inference
+      --deadline-fraction=<f>    Share of the block period a callback may take
+                                 before it counts as an xrun, default 1.0
+      --offline                  Run blocks back to back instead of in real time
+      --idle                     Don't register a consumer, as if the editor were closed
+      --model-dir=<dir>          Where to look for the ONNX models
+      --model-timeout=<s>        How long to wait for the model, default 60
+      --output=<file>            Write the report to a file as well
+      --trace=<file>             Write a Chrome trace of the run (needs a build
+                                 configured with AQUA_ENABLE_TRACING)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "AQUA/ParameterIDs.hpp"
+#include "AQUA/PluginProcessor.h"
+#include "AQUA/Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    double seconds = 30.0;
+    juce::File input;
+    juce::String signal = "mixed";
+    double detectionRateHz = AudioClassification::defaultDetectionRateHz;
+    std::vector<double> detectionRateSweepHz;
+    bool compareAlwaysOn = false;
+    double deadlineFraction = 1.0;
+    bool realtime = true;
+    bool hasConsumer = true;
+    double modelTimeoutSeconds = 60.0;
+    juce::File output;
+    juce::File trace;
+};
+
+constexpr int numChannels = 2;
+
+juce::File getFileForOption(const juce::ArgumentList& args, const juce::String& option)
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption(option).unquoted());
+}
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options options;
+
+    if (args.containsOption("--input"))
+        options.input = getFileForOption(args, "--input");
+
+    if (args.containsOption("--sample-rate"))
+        options.sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+
+    if (args.containsOption("--block-size"))
+        options.blockSize = args.getValueForOption("--block-size").getIntValue();
+
+    if (args.containsOption("--seconds"))
+        options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+
+    if (args.containsOption("--signal"))
+        options.signal = args.getValueForOption("--signal");
+
+    if (args.containsOption("--detection-rate"))
+        options.detectionRateHz = args.getValueForOption("--detection-rate").getDoubleValue();
+
+    if (args.containsOption("--detection-rates"))
+        for (const auto& rate : juce::StringArray::fromTokens(args.getValueForOption("--detection-rates"), ",", {}))
+            options.detectionRateSweepHz.push_back(rate.getDoubleValue());
+
+    if (args.containsOption("--deadline-fraction"))
+        options.deadlineFraction = args.getValueForOption("--deadline-fraction").getDoubleValue();
+
+    if (args.containsOption("--model-timeout"))
+        options.modelTimeoutSeconds = args.getValueForOption("--model-timeout").getDoubleValue();
+
+    if (args.containsOption("--model-dir"))
+        InferenceService::setModelDirectory(getFileForOption(args, "--model-dir"));
+
+    if (args.containsOption("--output"))
+        options.output = getFileForOption(args, "--output");
+
+    if (args.containsOption("--trace"))
+        options.trace = getFileForOption(args, "--trace");
+
+    options.compareAlwaysOn = args.containsOption("--compare-always-on");
+    options.realtime = !args.containsOption("--offline");
+    options.hasConsumer = !args.containsOption("--idle");
+
+    return options;
+}
+
+//===============================================================================================
+// Four-second scenes: a gliding tone over quiet noise, broadband noise bursts, then silence, so
+// a run goes through the model, the reuse path and the silence gate.
+void fillSyntheticSignal(juce::AudioBuffer<float>& buffer, const juce::String& signal, double sampleRate)
+{
+    juce::Random random(1234);
+    const auto sceneLength = static_cast<int>(4.0 * sampleRate);
+    auto phase = 0.0;
+
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        const auto scene = signal == "mixed" ? (i / sceneLength) % 3 : signal == "tone" ? 0 : signal == "noise" ? 1 : 2;
+        const auto timeInScene = static_cast<double>(i % sceneLength) / sampleRate;
+        auto sample = 0.0f;
+
+        if (scene == 0)
+        {
+            phase += juce::MathConstants<double>::twoPi * (440.0 + 110.0 * timeInScene) / sampleRate;
+            sample = 0.3f * static_cast<float>(std::sin(phase)) + 0.01f * (random.nextFloat() * 2.0f - 1.0f);
+        }
+        else if (scene == 1)
+        {
+            const auto envelope = std::fmod(timeInScene, 0.5) < 0.25 ? 0.5f : 0.05f;
+            sample = envelope * (random.nextFloat() * 2.0f - 1.0f);
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.setSample(channel, i, sample);
+    }
+}
+
+// Reads the whole file, converted to the host rate, and loops it to fill the buffer
+bool fillFromFile(juce::AudioBuffer<float>& buffer, const juce::File& file, double sampleRate)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    const std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return false;
+
+    const auto fileLength = static_cast<int>(reader->lengthInSamples);
+    juce::AudioBuffer<float> fileBuffer(numChannels, fileLength);
+    reader->read(&fileBuffer, 0, fileLength, 0, true, true); // A mono file is copied to both channels
+
+    const auto ratio = reader->sampleRate / sampleRate;
+    juce::AudioBuffer<float> converted(numChannels, static_cast<int>(fileLength / ratio));
+
+    if (converted.getNumSamples() == 0)
+        return false;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, fileBuffer.getReadPointer(channel), converted.getWritePointer(channel),
+                             converted.getNumSamples(), fileLength, 0);
+    }
+
+    for (int start = 0; start < buffer.getNumSamples(); start += converted.getNumSamples())
+    {
+        const auto numToCopy = juce::jmin(converted.getNumSamples(), buffer.getNumSamples() - start);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.copyFrom(channel, start, converted, channel, 0, numToCopy);
+    }
+
+    return true;
+}
+
+//===============================================================================================
+struct Summary
+{
+    double mean = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+Summary summarise(std::vector<double> values)
+{
+    if (values.empty())
+        return {};
+
+    std::sort(values.begin(), values.end());
+    const auto p99Index = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(values.size()))) - 1;
+
+    return { std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size()),
+             values[p99Index],
+             values.back() };
+}
+
+juce::var toVar(const Summary& summary)
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("mean", summary.mean);
+    object->setProperty("p99", summary.p99);
+    object->setProperty("max", summary.max);
+    return object;
+}
+
+juce::var toVar(const LatencyHistogram::Snapshot& snapshot)
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("count", static_cast<juce::int64>(snapshot.count));
+    object->setProperty("mean", snapshot.meanMs);
+    object->setProperty("p50", snapshot.p50Ms);
+    object->setProperty("p99", snapshot.p99Ms);
+    object->setProperty("p999", snapshot.p999Ms);
+    object->setProperty("max", snapshot.maxMs);
+    return object;
+}
+
+const char* getAnalysisStateName(AnalysisState state)
+{
+    switch (state)
+    {
+        case AnalysisState::warmingUp:   return "warmingUp";
+        case AnalysisState::running:     return "running";
+        case AnalysisState::unavailable: return "unavailable";
+    }
+
+    return "unknown";
+}
+
+double getNowMs()
+{
+    return juce::Time::getMillisecondCounterHiRes();
+}
+
+// Sleeps most of the way, then yields, so blocks start within a fraction of a millisecond
+void waitUntil(double targetMs)
+{
+    while (targetMs - getNowMs() > 2.0)
+        juce::Thread::sleep(1);
+
+    while (getNowMs() < targetMs)
+        juce::Thread::yield();
+}
+
+//===============================================================================================
+// One host session: a fresh processor prepared, played the whole source block by block, then
+// released. Everything is measured from this session only.
+struct Session
+{
+    juce::DynamicObject::Ptr config, callback, inference;
+
+    double meanLoad = 0.0;     // Mean callback time over the block period
+    double measuredLoad = 0.0; // What the plugin's own diagnostics report
+    double inferenceCpu = 0.0; // Model run time over the session's length, in cores
+    double processCpu = 0.0;   // CPU time of the whole process (every thread) over its length, in cores
+    int windowsSubmitted = 0;
+    int windowsReused = 0;
+    int xruns = 0;
+
+    // Every published result's group scores, keyed by the window end it belongs to
+    std::map<uint64_t, std::array<float, label_groups::numGroups>> groupScoresByWindowEnd;
+};
+
+double getTotalRunTimeMs(const LatencyHistogram::Snapshot& snapshot)
+{
+    return static_cast<double>(snapshot.count) * snapshot.meanMs;
+}
+
+Session runSession(const Options& options, const juce::AudioBuffer<float>& source, double detectionRateHz, bool reuseResults)
+{
+    Session session;
+    const auto numBlocks = source.getNumSamples() / options.blockSize;
+
+    webview_plugin::AudioPluginAudioProcessor processor;
+    auto& classifier = processor.getAudioClassification();
+
+    if (auto* detectionRate = processor.getState().getParameter(webview_plugin::id::DETECTION_RATE.getParamID()))
+        detectionRate->setValueNotifyingHost(detectionRate->convertTo0to1(static_cast<float>(detectionRateHz)));
+
+    if (!reuseResults)
+        classifier.setReuseToleranceDb(0.0f);
+
+    // Stands in for an open editor, so inference runs at the full rate
+    if (options.hasConsumer)
+        classifier.addConsumer();
+
+    processor.setPlayConfigDetails(numChannels, numChannels, options.sampleRate, options.blockSize);
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    const auto waitStartMs = getNowMs();
+
+    while (classifier.getAnalysisState() == AnalysisState::warmingUp
+           && getNowMs() - waitStartMs < options.modelTimeoutSeconds * 1000.0)
+    {
+        RealtimeLog::flush();
+        juce::Thread::sleep(50);
+    }
+
+    // ===== Block loop =====
+    const auto periodMs = 1000.0 * options.blockSize / options.sampleRate;
+    const auto deadlineMs = periodMs * options.deadlineFraction;
+
+    juce::AudioBuffer<float> block(numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+
+    std::vector<double> callbackMs;
+    std::vector<double> blockDoneMs(static_cast<size_t>(numBlocks));
+    std::vector<double> latencyMs;
+    callbackMs.reserve(static_cast<size_t>(numBlocks));
+
+    int numLateStarts = 0;
+    uint64_t lastSequence = 0;
+    uint64_t lastCollectedSequence = 0;
+    const auto flushInterval = juce::jmax(1, static_cast<int>(100.0 / periodMs));
+
+    // Collected as the run goes, so a long run can't outgrow the history ring
+    const auto collectResults = [&]
+    {
+        const auto columns = classifier.getHistory().getSince(lastCollectedSequence);
+
+        for (size_t row = 0; row < columns.size(); ++row)
+        {
+            auto& scores = session.groupScoresByWindowEnd[columns.audioPositions[row]];
+
+            for (size_t g = 0; g < label_groups::numGroups; ++g)
+                scores[g] = columns.groupScores[g][row];
+
+            lastCollectedSequence = columns.sequences[row];
+        }
+    };
+
+    const auto runTimeBefore = getTotalRunTimeMs(classifier.getLatencyStats().modelRun);
+    const auto clockBefore = std::clock();
+    const auto runStartMs = getNowMs();
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        if (options.realtime)
+        {
+            const auto dueMs = runStartMs + i * periodMs;
+
+            if (getNowMs() - dueMs > periodMs)
+                ++numLateStarts;
+
+            waitUntil(dueMs);
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            block.copyFrom(channel, 0, source, channel, i * options.blockSize, options.blockSize);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        const auto elapsedMs = 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+        callbackMs.push_back(elapsedMs);
+        blockDoneMs[static_cast<size_t>(i)] = getNowMs();
+
+        if (elapsedMs > deadlineMs)
+            ++session.xruns;
+
+        // Latency runs from the host handing over the block that completed the window to the
+        // result being readable, so it includes up to one block of polling granularity
+        const auto& result = classifier.getLatestResult();
+
+        if (result.sequence != lastSequence)
+        {
+            lastSequence = result.sequence;
+
+            const auto hostSamplePosition = static_cast<double>(result.audioPosition) * options.sampleRate / 16000.0;
+            const auto windowBlock = juce::jlimit(0, i, static_cast<int>(std::ceil(hostSamplePosition / options.blockSize)) - 1);
+            latencyMs.push_back(getNowMs() - blockDoneMs[static_cast<size_t>(windowBlock)]);
+        }
+
+        if (i % flushInterval == 0)
+        {
+            RealtimeLog::flush();
+            collectResults();
+        }
+    }
+
+    const auto runDurationMs = getNowMs() - runStartMs;
+    const auto processCpuMs = 1000.0 * static_cast<double>(std::clock() - clockBefore) / CLOCKS_PER_SEC;
+    const auto inferenceMs = getTotalRunTimeMs(classifier.getLatencyStats().modelRun) - runTimeBefore;
+    collectResults();
+
+    // ===== Report =====
+    const auto callbackSummary = summarise(callbackMs);
+    const auto throttleStats = classifier.getThrottleStats();
+    const auto silenceStats = classifier.getSilenceStats();
+    const auto reuseStats = classifier.getReuseStats();
+    const auto latencyStats = classifier.getLatencyStats();
+
+    session.meanLoad = callbackSummary.mean / periodMs;
+    session.measuredLoad = processor.getCpuLoad();
+    session.inferenceCpu = inferenceMs / runDurationMs;
+    session.processCpu = processCpuMs / runDurationMs;
+    session.windowsSubmitted = throttleStats.windowsSubmitted;
+    session.windowsReused = reuseStats.windowsReused;
+
+    session.config = new juce::DynamicObject();
+    session.config->setProperty("sampleRate", options.sampleRate);
+    session.config->setProperty("blockSize", options.blockSize);
+    session.config->setProperty("channels", numChannels);
+    session.config->setProperty("seconds", options.seconds);
+    session.config->setProperty("source", options.input != juce::File() ? options.input.getFileName() : options.signal);
+    session.config->setProperty("detectionRateHz", classifier.getDetectionRate());
+    session.config->setProperty("reuse", reuseResults);
+    session.config->setProperty("realtime", options.realtime);
+    session.config->setProperty("consumer", options.hasConsumer);
+
+    session.callback = new juce::DynamicObject();
+    session.callback->setProperty("count", static_cast<int>(callbackMs.size()));
+    session.callback->setProperty("periodMs", periodMs);
+    session.callback->setProperty("deadlineMs", deadlineMs);
+    session.callback->setProperty("timeMs", toVar(callbackSummary));
+    session.callback->setProperty("meanLoad", session.meanLoad);
+    session.callback->setProperty("measuredLoad", session.measuredLoad);
+    session.callback->setProperty("xruns", session.xruns);
+    session.callback->setProperty("lateStarts", numLateStarts);
+    session.callback->setProperty("runDurationMs", runDurationMs);
+
+    session.inference = new juce::DynamicObject();
+    session.inference->setProperty("state", getAnalysisStateName(classifier.getAnalysisState()));
+    session.inference->setProperty("results", static_cast<juce::int64>(lastSequence));
+    session.inference->setProperty("latencyMs", toVar(summarise(latencyMs)));
+    session.inference->setProperty("serviceLatencyMs", toVar(latencyStats.inference));
+    session.inference->setProperty("modelRunMs", toVar(latencyStats.modelRun));
+    session.inference->setProperty("resamplingMs", toVar(latencyStats.resampling));
+    session.inference->setProperty("timeToFirstScoreMs", classifier.getTimeToFirstScoreMs());
+    session.inference->setProperty("windowsSubmitted", throttleStats.windowsSubmitted);
+    session.inference->setProperty("windowsThrottled", throttleStats.windowsThrottled);
+    session.inference->setProperty("windowsGated", silenceStats.windowsGated);
+    session.inference->setProperty("windowsReused", reuseStats.windowsReused);
+    session.inference->setProperty("droppedSamples", classifier.getNumDroppedSamples());
+    session.inference->setProperty("droppedWindows", classifier.getNumDroppedWindows());
+    session.inference->setProperty("windowsLate", latencyStats.windowsLate);
+    session.inference->setProperty("cpu", session.inferenceCpu);
+    session.inference->setProperty("processCpu", session.processCpu);
+
+    processor.releaseResources();
+
+    if (options.hasConsumer)
+        classifier.removeConsumer();
+
+    RealtimeLog::flush();
+    return session;
+}
+
+juce::var toVar(const Session& session)
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("config", session.config.get());
+    object->setProperty("callback", session.callback.get());
+    object->setProperty("inference", session.inference.get());
+    return object;
+}
+
+//===============================================================================================
+// Lines up the two runs' results by window end and compares the reuse run against always-on
+// inference: how often the top group matches, and how far each group's score is out
+juce::var compareWithAlwaysOn(const Session& reuse, const Session& alwaysOn)
+{
+    std::array<double, label_groups::numGroups> sumOfErrors {};
+    std::array<double, label_groups::numGroups> maxErrors {};
+    int numCompared = 0;
+    int numTopGroupsAgreed = 0;
+
+    const auto getTopGroup = [](const auto& scores) { return std::distance(scores.begin(), std::max_element(scores.begin(), scores.end())); };
+
+    for (const auto& [windowEnd, scores] : reuse.groupScoresByWindowEnd)
+    {
+        const auto reference = alwaysOn.groupScoresByWindowEnd.find(windowEnd);
+
+        // Windows one run dropped or hadn't finished can't be compared
+        if (reference == alwaysOn.groupScoresByWindowEnd.end())
+            continue;
+
+        ++numCompared;
+
+        if (getTopGroup(scores) == getTopGroup(reference->second))
+            ++numTopGroupsAgreed;
+
+        for (size_t g = 0; g < label_groups::numGroups; ++g)
+        {
+            const auto error = std::abs(static_cast<double>(scores[g]) - static_cast<double>(reference->second[g]));
+            sumOfErrors[g] += error;
+            maxErrors[g] = juce::jmax(maxErrors[g], error);
+        }
+    }
+
+    auto* groups = new juce::DynamicObject();
+
+    for (size_t g = 0; g < label_groups::numGroups; ++g)
+    {
+        auto* group = new juce::DynamicObject();
+        group->setProperty("meanAbsError", numCompared > 0 ? sumOfErrors[g] / numCompared : 0.0);
+        group->setProperty("maxAbsError", maxErrors[g]);
+        groups->setProperty(label_groups::groups[g].name, group);
+    }
+
+    auto* comparison = new juce::DynamicObject();
+    comparison->setProperty("windowsCompared", numCompared);
+    comparison->setProperty("windowsReused", reuse.windowsReused);
+    comparison->setProperty("topGroupAgreement", numCompared > 0 ? static_cast<double>(numTopGroupsAgreed) / numCompared : 0.0);
+    comparison->setProperty("groups", groups);
+    return comparison;
+}
+
+// The sweep as a Markdown table, for pasting into the README or a PR
+void printDetectionRateTable(const std::vector<double>& ratesHz, const std::vector<Session>& sessions)
+{
+    std::cerr << "| Detection rate (Hz) | Callback load | Measured load | Inference CPU | Process CPU | Windows run | Reused | Xruns |\n"
+              << "|---|---|---|---|---|---|---|---|\n";
+
+    for (size_t i = 0; i < sessions.size(); ++i)
+    {
+        const auto& session = sessions[i];
+        std::cerr << "| " << juce::String(ratesHz[i], 2) << " | " << juce::String(100.0 * session.meanLoad, 2) << "% | "
+                  << juce::String(100.0 * session.measuredLoad, 2) << "% | " << juce::String(100.0 * session.inferenceCpu, 1) << "% | "
+                  << juce::String(100.0 * session.processCpu, 1) << "% | " << session.windowsSubmitted << " | " << session.windowsReused
+                  << " | " << session.xruns << " |\n";
+    }
+
+    std::cerr << std::flush;
+}
+} // namespace
+
+//===============================================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args(argc, argv);
+    auto options = parseOptions(args);
+
+    // A file plays at its own rate unless the host rate is given explicitly
+    if (options.input != juce::File() && !args.containsOption("--sample-rate"))
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        if (const std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(options.input)); reader != nullptr)
+            options.sampleRate = reader->sampleRate;
+    }
+
+    if (options.sampleRate <= 0.0 || options.blockSize <= 0 || options.seconds <= 0.0)
+    {
+        std::cerr << "Sample rate, block size and length must all be positive." << std::endl;
+        return 1;
+    }
+
+    if (options.compareAlwaysOn && !options.detectionRateSweepHz.empty())
+    {
+        std::cerr << "--compare-always-on and --detection-rates can't be combined." << std::endl;
+        return 1;
+    }
+
+    const auto numBlocks = static_cast<int>(options.seconds * options.sampleRate / options.blockSize);
+    juce::AudioBuffer<float> source(numChannels, numBlocks * options.blockSize);
+
+    if (options.input != juce::File())
+    {
+        if (!fillFromFile(source, options.input, options.sampleRate))
+        {
+            std::cerr << "Could not read " << options.input.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        fillSyntheticSignal(source, options.signal, options.sampleRate);
+    }
+
+    // Shared by every session, so the model loads once and later sessions start warm
+    juce::SharedResourcePointer<InferenceService> inferenceService;
+    auto* report = new juce::DynamicObject();
+
+    if (options.compareAlwaysOn)
+    {
+        // Same input, same rate; the only difference is whether steady windows reuse a result
+        const auto reuse = runSession(options, source, options.detectionRateHz, true);
+        const auto alwaysOn = runSession(options, source, options.detectionRateHz, false);
+
+        report->setProperty("reuse", toVar(reuse));
+        report->setProperty("alwaysOn", toVar(alwaysOn));
+        report->setProperty("comparison", compareWithAlwaysOn(reuse, alwaysOn));
+    }
+    else if (!options.detectionRateSweepHz.empty())
+    {
+        std::vector<Session> sessions;
+        juce::Array<juce::var> sweep;
+
+        for (const auto rateHz : options.detectionRateSweepHz)
+        {
+            sessions.push_back(runSession(options, source, rateHz, true));
+            sweep.add(toVar(sessions.back()));
+        }
+
+        report->setProperty("detectionRateSweep", sweep);
+        printDetectionRateTable(options.detectionRateSweepHz, sessions);
+    }
+    else
+    {
+        const auto session = runSession(options, source, options.detectionRateHz, true);
+        report->setProperty("config", session.config.get());
+        report->setProperty("callback", session.callback.get());
+        report->setProperty("inference", session.inference.get());
+    }
+
+    auto* model = new juce::DynamicObject();
+    model->setProperty("state", inferenceService->isReady() ? "ready" : "unavailable");
+    model->setProperty("loadTimeMs", inferenceService->getModelLoadTimeMs());
+    model->setProperty("fromCache", inferenceService->wasLoadedFromCache());
+    model->setProperty("batching", inferenceService->supportsBatching());
+    model->setProperty("meanWindowRunTimeMs", inferenceService->getMeanWindowRunTimeMs());
+
+    report->setProperty("model", model);
+    report->setProperty("droppedLogMessages", static_cast<juce::int64>(RealtimeLog::getNumDroppedMessages()));
+
+    const auto json = juce::JSON::toString(juce::var(report));
+    std::cout << json << std::endl;
+
+    if (options.output != juce::File() && !options.output.replaceWithText(json))
+        std::cerr << "Could not write " << options.output.getFullPathName() << std::endl;
+
+    if (options.trace != juce::File() && !trace::writeChromeTrace(options.trace))
+        std::cerr << "Could not write a trace to " << options.trace.getFullPathName()
+                  << (trace::isEnabled ? "" : " (tracing is compiled out)") << std::endl;
+
+    RealtimeLog::flushAll();
+    return 0;
+}